@@ -3,11 +3,218 @@
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include <queue>
+#include <deque>
+#include <algorithm>
+#include <memory>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+#include <unordered_map>
 #include <optional>
+#include <string>
+#include <fstream>
+#include <sstream>
 
-std::condition_variable cv;
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <linux/perf_event.h>
+#endif
+
+// Build with -DAMS_WITH_IO_URING and -luring to enable the io_uring journal backend
+#ifdef AMS_WITH_IO_URING
+#include <liburing.h>
+#endif
+
+// Milliseconds since the scheduler started; used for runway occupancy timestamps
+const auto schedulerStart = std::chrono::steady_clock::now();
+long long nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - schedulerStart).count();
+}
+
+// Sampling profiler (--profile PATH). Each thread carries a role and a phase tag, two
+// levels deep, in thread-local storage. ITIMER_PROF raises SIGPROF about SAMPLE_HZ
+// times per CPU-second, on whichever thread is running, and the handler bumps one
+// lock-free counter for that thread's role and phases. Tagging a phase is a
+// thread-local store and a sample is one relaxed increment, which keeps the overhead
+// well under 1%. Blocked threads use no CPU, so they are not sampled.
+enum class ThreadRole : uint8_t { Other, Main, Monitor, Landing, RunwayWorker, Optimizer, Watcher };
+constexpr int NUM_THREAD_ROLES = 7;
+constexpr const char* THREAD_ROLE_NAMES[NUM_THREAD_ROLES] = {
+    "other", "main", "monitor", "landing", "runway-worker", "optimizer", "watcher"};
+
+enum class Phase : uint8_t { Untagged, Intake, Dispatch, Matching, Landing, Release, Logging, Optimize };
+constexpr int NUM_PHASES = 8;
+constexpr const char* PHASE_NAMES[NUM_PHASES] = {
+    "untagged", "intake", "dispatch", "matching", "landing", "release", "logging", "optimize"};
+
+thread_local std::atomic<uint8_t> currentRole{0};
+thread_local std::atomic<uint16_t> currentPhase{0}; // outer phase in the low byte, inner in the high
+
+std::atomic<uint64_t> profileSamples[NUM_THREAD_ROLES][NUM_PHASES][NUM_PHASES];
+
+void setThreadRole(ThreadRole role) {
+    currentRole.store(static_cast<uint8_t>(role), std::memory_order_relaxed);
+}
+
+// Tags the calling thread with `phase` for the lifetime of the scope. Inside another
+// phase it becomes the inner tag; deeper nesting replaces the inner tag.
+class PhaseScope {
+public:
+    explicit PhaseScope(Phase phase) : saved(currentPhase.load(std::memory_order_relaxed)) {
+        uint16_t tag = static_cast<uint16_t>(phase);
+        currentPhase.store((saved & 0xff) == 0 ? tag : static_cast<uint16_t>((saved & 0xff) | tag << 8),
+                           std::memory_order_relaxed);
+    }
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+    ~PhaseScope() { currentPhase.store(saved, std::memory_order_relaxed); }
+
+private:
+    uint16_t saved;
+};
+
+class PhaseProfiler {
+public:
+    static constexpr int SAMPLE_HZ = 997; // off the round numbers, so it does not beat with periodic work
+
+    bool start() {
+        struct sigaction action = {};
+        action.sa_handler = onSample;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, nullptr) != 0) return false;
+        itimerval timer = {};
+        timer.it_interval.tv_usec = 1000000 / SAMPLE_HZ;
+        timer.it_value = timer.it_interval;
+        running = setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+        return running;
+    }
+
+    void stop() {
+        if (!running) return;
+        itimerval timer = {};
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        signal(SIGPROF, SIG_IGN);
+        running = false;
+    }
+
+    // Folded stacks, one "role;phase[;phase] count" line each, for flamegraph.pl
+    bool writeFolded(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        for (int role = 0; role < NUM_THREAD_ROLES; ++role) {
+            for (int outer = 0; outer < NUM_PHASES; ++outer) {
+                for (int inner = 0; inner < NUM_PHASES; ++inner) {
+                    uint64_t count = profileSamples[role][outer][inner].load(std::memory_order_relaxed);
+                    if (count == 0) continue;
+                    out << THREAD_ROLE_NAMES[role] << ";" << PHASE_NAMES[outer];
+                    if (inner != 0) out << ";" << PHASE_NAMES[inner];
+                    out << " " << count << "\n";
+                }
+            }
+        }
+        return static_cast<bool>(out);
+    }
+
+    // Share of CPU samples by innermost phase
+    void printBreakdown() const {
+        uint64_t byPhase[NUM_PHASES] = {};
+        uint64_t total = 0;
+        for (int role = 0; role < NUM_THREAD_ROLES; ++role) {
+            for (int outer = 0; outer < NUM_PHASES; ++outer) {
+                for (int inner = 0; inner < NUM_PHASES; ++inner) {
+                    uint64_t count = profileSamples[role][outer][inner].load(std::memory_order_relaxed);
+                    byPhase[inner != 0 ? inner : outer] += count;
+                    total += count;
+                }
+            }
+        }
+        std::cout << "Profile: " << total << " samples (~" << total * 1000 / SAMPLE_HZ << " ms CPU)";
+        for (int phase = 0; phase < NUM_PHASES; ++phase) {
+            if (byPhase[phase] > 0) std::cout << ", " << PHASE_NAMES[phase] << " " << 100.0 * byPhase[phase] / total << "%";
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    bool running = false;
+
+    static void onSample(int) {
+        uint16_t phase = currentPhase.load(std::memory_order_relaxed);
+        profileSamples[currentRole.load(std::memory_order_relaxed)][phase & 0xff][phase >> 8].fetch_add(
+            1, std::memory_order_relaxed);
+    }
+};
+
+// ICAO wake turbulence categories; Super is the A380 class
+enum class AircraftCategory : uint8_t { Light = 0, Medium = 1, Heavy = 2, Super = 3 };
+constexpr int NUM_AIRCRAFT_CATEGORIES = 4;
+
+struct CategoryProfile {
+    char code;               // input letter: L, M, H or J
+    uint8_t occupancyPercent; // runway occupancy relative to the runway's configured time
+    uint8_t taxiSpeedPercent; // taxi speed relative to a medium jet
+    uint16_t rolloutMeters;   // landing roll before the aircraft can turn off the runway
+};
+
+constexpr CategoryProfile CATEGORY_PROFILES[NUM_AIRCRAFT_CATEGORIES] = {
+    {'L', 70, 80, 900},
+    {'M', 100, 100, 1500},
+    {'H', 125, 90, 2100},
+    {'J', 140, 75, 2500},
+};
+
+// Extra runway time a follower must leave behind a leader for wake turbulence, in ms of
+// simulated time, indexed [leader][follower]
+constexpr uint16_t WAKE_SEPARATION_MS[NUM_AIRCRAFT_CATEGORIES][NUM_AIRCRAFT_CATEGORIES] = {
+    //  L     M     H     J   follower
+    {   0,    0,    0,    0},  // behind Light
+    { 300,    0,    0,    0},  // behind Medium
+    { 600,  500,  400,    0},  // behind Heavy
+    { 800,  700,  600,  400},  // behind Super
+};
+
+constexpr const CategoryProfile& profileOf(AircraftCategory category) {
+    return CATEGORY_PROFILES[static_cast<int>(category)];
+}
+
+constexpr uint16_t wakeSeparationMs(AircraftCategory leader, AircraftCategory follower) {
+    return WAKE_SEPARATION_MS[static_cast<int>(leader)][static_cast<int>(follower)];
+}
+
+static_assert(wakeSeparationMs(AircraftCategory::Super, AircraftCategory::Light) >
+              wakeSeparationMs(AircraftCategory::Medium, AircraftCategory::Light),
+              "heavier leaders need at least as much separation");
+
+AircraftCategory categoryFromCode(char code) {
+    for (int c = 0; c < NUM_AIRCRAFT_CATEGORIES; ++c) {
+        if (CATEGORY_PROFILES[c].code == code) return static_cast<AircraftCategory>(c);
+    }
+    return AircraftCategory::Medium;
+}
 
 class Flight {
 public:
@@ -15,201 +222,3647 @@ public:
     std::string type; // "arrival" or "departure"
     int priority;
     std::string time;
-    std::string status; // "waiting", "assigned", "landed"
+    int handle;         // flight store handle (slot and generation), -1 if untracked
+    int gate;           // 0 when the gate is unknown
+    std::string airline; // carrier code, empty when unknown
+    int plannedRunway;   // runway from the loaded slot plan, 0 when unplanned
+    AircraftCategory category;
+
+    Flight(int id, const std::string& type, int priority, const std::string& time, int gate = 0,
+           const std::string& airline = "", AircraftCategory category = AircraftCategory::Medium)
+        : id(id), type(type), priority(priority), time(time), handle(-1), gate(gate), airline(airline),
+          plannedRunway(0), category(category) {}
+};
+
+// Minutes after midnight for an "HH:MM" flight time; -1 if it does not parse
+int minuteOfDay(const std::string& time) {
+    int hours = 0, minutes = 0;
+    char colon = 0;
+    std::istringstream in(time);
+    if (!(in >> hours >> colon >> minutes) || colon != ':' || hours < 0 || hours > 23 || minutes < 0 || minutes > 59) {
+        return -1;
+    }
+    return hours * 60 + minutes;
+}
+
+// Flight lifecycle. Each flight moves forward only:
+//   Scheduled -> Queued -> Assigned -> OnRunway -> Completed
+// and may be Cancelled while Scheduled (rejected at intake) or Queued (shed or drained).
+enum class FlightState : uint8_t { Scheduled, Queued, Assigned, OnRunway, Completed, Cancelled };
+constexpr int NUM_FLIGHT_STATES = 6;
+
+constexpr const char* FLIGHT_STATE_NAMES[NUM_FLIGHT_STATES] = {
+    "scheduled", "queued", "assigned", "on-runway", "completed", "cancelled"};
+
+// ALLOWED_TRANSITIONS[from] is a bit set of the states `from` may move to
+constexpr uint8_t stateBit(FlightState state) { return 1u << static_cast<int>(state); }
+constexpr uint8_t ALLOWED_TRANSITIONS[NUM_FLIGHT_STATES] = {
+    stateBit(FlightState::Queued) | stateBit(FlightState::Cancelled), // Scheduled
+    stateBit(FlightState::Assigned) | stateBit(FlightState::Cancelled), // Queued
+    stateBit(FlightState::OnRunway),                                   // Assigned
+    stateBit(FlightState::Completed),                                  // OnRunway
+    0,                                                                 // Completed
+    0,                                                                 // Cancelled
+};
+
+constexpr int NO_FLIGHT = -1;
+constexpr int LANDING_TIME_SECONDS = 2;
 
-    Flight(int id, const std::string& type, int priority, const std::string& time)
-        : id(id), type(type), priority(priority), time(time), status("waiting") {}
+// Consistent view of what a runway is doing, readable without taking any lock
+struct RunwayOccupancy {
+    int flightId;             // NO_FLIGHT when the runway is free
+    long long sinceMs;        // when the current flight took the runway
+    long long expectedFreeMs; // when the runway is expected to be free again
 };
 
 class Runway {
 public:
     int id;
     bool isAvailable;
-    Flight* currentFlight;
+    std::atomic<int> taxiMovements{0}; // flights taxiing between this runway and a gate
+    AircraftCategory lastCategory = AircraftCategory::Light; // previous movement, guarded by runwayMutex
+    long long lastFreeMs = 0; // when the previous movement was booked to clear, guarded by runwayMutex
 
-    Runway(int id) : id(id), isAvailable(true), currentFlight(nullptr) {}
+    Runway(int id) : id(id), isAvailable(true) {}
 
     // Delete copy constructor and copy assignment operator
     Runway(const Runway&) = delete;
     Runway& operator=(const Runway&) = delete;
 
     // Allow move constructor and move assignment
-    Runway(Runway&& other) noexcept : id(other.id), isAvailable(other.isAvailable),
-                                      currentFlight(other.currentFlight) {
-        other.currentFlight = nullptr; // Invalidate the moved-from object
+    Runway(Runway&& other) noexcept : id(other.id), isAvailable(other.isAvailable) {
+        copyOccupancyFrom(other);
+        taxiMovements.store(other.taxiMovements.load());
+        lastCategory = other.lastCategory;
+        lastFreeMs = other.lastFreeMs;
     }
 
     Runway& operator=(Runway&& other) noexcept {
         if (this != &other) {
             id = other.id;
             isAvailable = other.isAvailable;
-            currentFlight = other.currentFlight;
-            other.currentFlight = nullptr; // Invalidate the moved-from object
+            copyOccupancyFrom(other);
+            taxiMovements.store(other.taxiMovements.load());
+            lastCategory = other.lastCategory;
+            lastFreeMs = other.lastFreeMs;
         }
         return *this;
     }
 
-    bool assignFlight(Flight* flight) {
-        std::lock_guard<std::mutex> lock(runwayMutex);
-        if (isAvailable) {
-            currentFlight = flight;
-            isAvailable = false; // Mark the runway as occupied
-            return true; // Flight assigned successfully
+    // Publish the runway occupancy under the sequence lock. Writers must already be
+    // serialized by the caller; they pay one store to open and one to close the update.
+    void publishOccupancy(int flightId, long long sinceMs, long long expectedFreeMs) {
+        unsigned seq = occupancySeq.load(std::memory_order_relaxed);
+        occupancySeq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        occupiedBy.store(flightId, std::memory_order_relaxed);
+        occupiedSinceMs.store(sinceMs, std::memory_order_relaxed);
+        expectedFreeAtMs.store(expectedFreeMs, std::memory_order_relaxed);
+        occupancySeq.store(seq + 2, std::memory_order_release);
+    }
+
+    void clearOccupancy() {
+        publishOccupancy(NO_FLIGHT, 0, 0);
+    }
+
+    // Lock-free read; retries while a writer is mid-update
+    RunwayOccupancy readOccupancy() const {
+        RunwayOccupancy snapshot;
+        unsigned before, after;
+        do {
+            before = occupancySeq.load(std::memory_order_acquire);
+            snapshot.flightId = occupiedBy.load(std::memory_order_relaxed);
+            snapshot.sinceMs = occupiedSinceMs.load(std::memory_order_relaxed);
+            snapshot.expectedFreeMs = expectedFreeAtMs.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = occupancySeq.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return snapshot;
+    }
+
+private:
+    // Sequence lock: odd while a write is in progress
+    std::atomic<unsigned> occupancySeq{0};
+    std::atomic<int> occupiedBy{NO_FLIGHT};
+    std::atomic<long long> occupiedSinceMs{0};
+    std::atomic<long long> expectedFreeAtMs{0};
+
+    void copyOccupancyFrom(const Runway& other) {
+        RunwayOccupancy snapshot = other.readOccupancy();
+        publishOccupancy(snapshot.flightId, snapshot.sinceMs, snapshot.expectedFreeMs);
+    }
+};
+// xoshiro256** (Blackman and Vigna): small, fast and deterministic for a given seed
+class Xoshiro256 {
+public:
+    explicit Xoshiro256(uint64_t seed = 1) { reseed(seed); }
+
+    // Expands the seed with splitmix64 so that nearby seeds give unrelated streams
+    void reseed(uint64_t seed) {
+        for (auto& word : state) {
+            seed += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
         }
-        return false; // Runway is not available
     }
 
-    void releaseAfterDelay(int seconds) {
-        std::this_thread::sleep_for(std::chrono::seconds(seconds));
-        {
-            std::lock_guard<std::mutex> lock(runwayMutex);
-            isAvailable = true;
-            currentFlight = nullptr;
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1) from the top 53 bits
+    double uniform() { return (next() >> 11) * 0x1.0p-53; }
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+// Vose's alias method: O(n) to build, O(1) per sample from a discrete distribution
+class AliasTable {
+public:
+    AliasTable() = default;
+
+    explicit AliasTable(const std::vector<double>& weights) {
+        size_t n = weights.size();
+        probability.assign(n, 0);
+        alias.assign(n, 0);
+        double total = 0;
+        for (double weight : weights) total += weight;
+        if (n == 0 || total <= 0) return;
+
+        std::vector<double> scaled(n);
+        std::vector<uint32_t> small, large;
+        for (size_t i = 0; i < n; ++i) {
+            scaled[i] = weights[i] * n / total;
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+        }
+        while (!small.empty() && !large.empty()) {
+            uint32_t less = small.back(), more = large.back();
+            small.pop_back();
+            probability[less] = scaled[less];
+            alias[less] = more;
+            scaled[more] -= 1.0 - scaled[less];
+            if (scaled[more] < 1.0) {
+                large.pop_back();
+                small.push_back(more);
+            }
         }
-        cv.notify_one(); // Notify the waiting thread immediately
-        std::cout << "Runway " << id << " is now available." << std::endl;
+        for (uint32_t i : large) probability[i] = 1.0;
+        for (uint32_t i : small) probability[i] = 1.0; // only reached through rounding error
+    }
+
+    size_t size() const { return probability.size(); }
+
+    size_t sample(Xoshiro256& rng) const {
+        uint64_t bits = rng.next();
+        size_t column = static_cast<size_t>((bits >> 32) * probability.size() >> 32);
+        double coin = (bits & 0xffffffffULL) * 0x1.0p-32;
+        return coin < probability[column] ? column : alias[column];
     }
 
 private:
-    std::mutex runwayMutex;
+    std::vector<double> probability;
+    std::vector<uint32_t> alias;
 };
 
-std::vector<Runway> runways;
-std::mutex flightsMutex;
+enum class OccupancyKind : int32_t { Fixed = 0, LogNormal = 1, Empirical = 2 };
 
-std::queue<Flight> preemptedFlights;
-std::queue<Flight> regularFlights;
+struct OccupancyBin {
+    int32_t ms;
+    float weight;
+};
 
-std::mutex runwayMutex;
-std::condition_variable runwayAvailableCV;
-void assignLanding(Flight& flight) {
-    std::unique_lock<std::mutex> lock(runwayMutex);
-    
-    for (auto& runway : runways) {
-        if (runway.isAvailable) {
-            runway.isAvailable = false;
-            std::cout << "Landing Flight ID: " << flight.id << " assigned to runway " << runway.id << "." << std::endl;
-            lock.unlock();
-            
-            // Simulate landing time
-            std::this_thread::sleep_for(std::chrono::seconds(2));
+// How long a movement keeps a runway busy: the configured time, a lognormal around it
+// (the configured time is the median), or an empirical histogram sampled by alias table
+class OccupancyModel {
+public:
+    OccupancyKind kind = OccupancyKind::Fixed;
+    int32_t baseMs = 0;
+    double sigma = 0;
 
-            // Mark runway as available
-            lock.lock();
-            runway.isAvailable = true;
-            std::cout << "Runway " << runway.id << " is now available." << std::endl;
-            
-            // Notify checkWaitingFlights about the availability
-            runwayAvailableCV.notify_one();
-            break;
+    OccupancyModel() = default;
+    OccupancyModel(OccupancyKind kind, int32_t baseMs, double sigma, const std::vector<OccupancyBin>& bins)
+        : kind(kind), baseMs(baseMs), sigma(sigma) {
+        std::vector<double> weights;
+        for (const auto& bin : bins) {
+            valuesMs.push_back(bin.ms);
+            weights.push_back(bin.weight);
+        }
+        table = AliasTable(weights);
+        if (kind == OccupancyKind::Empirical && table.size() == 0) this->kind = OccupancyKind::Fixed;
+    }
+
+    int32_t sample(Xoshiro256& rng) const {
+        switch (kind) {
+            case OccupancyKind::LogNormal: {
+                // Box-Muller; 1 - u keeps the logarithm finite
+                double z = std::sqrt(-2.0 * std::log(1.0 - rng.uniform())) * std::cos(2.0 * M_PI * rng.uniform());
+                return std::max<int32_t>(1, static_cast<int32_t>(baseMs * std::exp(sigma * z)));
+            }
+            case OccupancyKind::Empirical:
+                return valuesMs[table.sample(rng)];
+            case OccupancyKind::Fixed:
+                break;
+        }
+        return baseMs;
+    }
+
+private:
+    std::vector<int32_t> valuesMs;
+    AliasTable table;
+};
+
+struct OccupancyDistributionConfig {
+    int32_t runwayId;
+    OccupancyKind kind;
+    float sigma;
+    std::vector<OccupancyBin> bins;
+};
+
+struct RunwayConfig {
+    int32_t id;
+    int32_t occupancyMs;
+};
+
+// Precomputed exit for a landing on one runway by one aircraft category heading to one
+// gate. occupancyPercent is 0 when the runway has no exit model.
+struct ExitChoice {
+    uint8_t occupancyPercent; // runway occupancy up to this exit, relative to the runway time
+    uint8_t exitIndex;        // position of the exit in the runway's configuration
+    uint16_t taxiSeconds;     // exit to gate, UNREACHABLE_TAXI if unknown
+};
+
+constexpr uint16_t UNREACHABLE_TAXI = UINT16_MAX;
+
+// Everything needed to bring up the scheduler without interactive input
+struct AirportConfig {
+    std::vector<RunwayConfig> runways;
+    int32_t gateCount = 0;                // gates are numbered 1..gateCount
+    std::vector<uint16_t> taxiSeconds;    // gateCount rows of runways.size() shortest taxi times
+    std::vector<OccupancyDistributionConfig> occupancyModels; // runways without one are fixed
+    // runways.size() x NUM_AIRCRAFT_CATEGORIES x (gateCount + 1) exit choices; gate 0 is
+    // "gate unknown" and takes the exit that frees the runway soonest
+    std::vector<ExitChoice> exitChoices;
+};
+
+size_t exitChoiceIndex(size_t runway, AircraftCategory category, int gate, int gateCount) {
+    return (runway * NUM_AIRCRAFT_CATEGORIES + static_cast<size_t>(category)) * (gateCount + 1) + gate;
+}
+
+// Shortest taxi time from every node to `source` over the undirected taxiway graph
+std::vector<int> taxiDistancesFrom(int source, const std::vector<std::vector<std::pair<int, int>>>& edges) {
+    std::vector<int> distance(edges.size(), INT32_MAX);
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> frontier;
+    distance[source] = 0;
+    frontier.push({0, source});
+    while (!frontier.empty()) {
+        auto [d, node] = frontier.top();
+        frontier.pop();
+        if (d > distance[node]) continue;
+        for (auto [next, seconds] : edges[node]) {
+            if (d + seconds < distance[next]) {
+                distance[next] = d + seconds;
+                frontier.push({distance[next], next});
+            }
         }
     }
+    return distance;
 }
 
+// Reads the text form of a configuration:
+//   runway <id> <occupancyMs> [<taxiway node>]
+//   gate <id> <taxiway node>
+//   taxiway <node> <node> <seconds>
+//   occupancy <runway id> lognormal <sigma>
+//   occupancy <runway id> empirical <ms> <weight> [<ms> <weight> ...]
+//   exit <runway id> <distance m> <occupancy %> <taxiway node>
+// and precomputes the gate-to-runway shortest taxi times (one Dijkstra per runway) and
+// the best exit for every runway, aircraft category and gate (one Dijkstra per exit).
+bool loadAirportConfigText(const std::string& path, AirportConfig& config) {
+    std::ifstream file(path);
+    if (!file) return false;
+    config = AirportConfig();
+    std::vector<int> runwayNodes, gateNodes;
+    std::vector<std::vector<std::pair<int, int>>> edges;
+    struct Exit {
+        int runwayId, distance, occupancyPercent, node;
+    };
+    std::vector<Exit> exits;
+    auto ensureNode = [&edges](int node) {
+        if (node >= static_cast<int>(edges.size())) edges.resize(node + 1);
+    };
 
-void checkWaitingFlights() {
-    while (true) {
-        std::unique_lock<std::mutex> lock(runwayMutex);
-        
-        // Wait for a runway to become available if all are occupied
-        runwayAvailableCV.wait(lock, [] {
-            for (const auto& runway : runways) {
-                if (runway.isAvailable) return true;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+        std::string keyword;
+        if (!(in >> keyword) || keyword[0] == '#') continue;
+        if (keyword == "runway") {
+            RunwayConfig runway;
+            int node = -1;
+            if (!(in >> runway.id >> runway.occupancyMs)) return false;
+            in >> node;
+            config.runways.push_back(runway);
+            runwayNodes.push_back(node);
+        } else if (keyword == "gate") {
+            int gate, node;
+            if (!(in >> gate >> node) || gate < 1 || node < 0) return false;
+            if (gate > static_cast<int>(gateNodes.size())) gateNodes.resize(gate, -1);
+            gateNodes[gate - 1] = node;
+        } else if (keyword == "occupancy") {
+            OccupancyDistributionConfig model;
+            std::string kind;
+            if (!(in >> model.runwayId >> kind)) return false;
+            model.sigma = 0;
+            if (kind == "lognormal") {
+                model.kind = OccupancyKind::LogNormal;
+                if (!(in >> model.sigma) || model.sigma < 0) return false;
+            } else if (kind == "empirical") {
+                model.kind = OccupancyKind::Empirical;
+                OccupancyBin bin;
+                while (in >> bin.ms >> bin.weight) {
+                    if (bin.ms <= 0 || bin.weight < 0) return false;
+                    model.bins.push_back(bin);
+                }
+                if (model.bins.empty()) return false;
+            } else {
+                return false;
+            }
+            config.occupancyModels.push_back(model);
+        } else if (keyword == "exit") {
+            Exit exit;
+            if (!(in >> exit.runwayId >> exit.distance >> exit.occupancyPercent >> exit.node) ||
+                exit.occupancyPercent < 1 || exit.occupancyPercent > 255 || exit.node < 0) {
+                return false;
             }
+            exits.push_back(exit);
+        } else if (keyword == "taxiway") {
+            int from, to, seconds;
+            if (!(in >> from >> to >> seconds) || from < 0 || to < 0 || seconds < 0) return false;
+            ensureNode(std::max(from, to));
+            edges[from].push_back({to, seconds});
+            edges[to].push_back({from, seconds});
+        } else {
             return false;
-        });
+        }
+    }
+    if (config.runways.empty()) return false;
 
-        // Check and assign any waiting flights
-        if (!preemptedFlights.empty()) {
-            Flight flight = preemptedFlights.front();
-            preemptedFlights.pop();
-            assignLanding(flight); // This will assign a free runway to the flight
-        } else if (!regularFlights.empty()) {
-            Flight flight = regularFlights.front();
-            regularFlights.pop();
-            assignLanding(flight);
+    config.gateCount = static_cast<int32_t>(gateNodes.size());
+    config.taxiSeconds.assign(gateNodes.size() * config.runways.size(), UNREACHABLE_TAXI);
+    for (size_t r = 0; r < config.runways.size(); ++r) {
+        int source = runwayNodes[r];
+        if (source < 0 || source >= static_cast<int>(edges.size())) continue;
+        std::vector<int> distance = taxiDistancesFrom(source, edges);
+        for (size_t g = 0; g < gateNodes.size(); ++g) {
+            int node = gateNodes[g];
+            if (node < 0 || node >= static_cast<int>(distance.size()) || distance[node] >= UNREACHABLE_TAXI) continue;
+            config.taxiSeconds[g * config.runways.size() + r] = static_cast<uint16_t>(distance[node]);
         }
+    }
 
-        // Break if no more flights are in the queues and all runways are free
-        if (preemptedFlights.empty() && regularFlights.empty()) {
-            bool allRunwaysFree = true;
-            for (const auto& runway : runways) {
-                if (!runway.isAvailable) {
-                    allRunwaysFree = false;
-                    break;
+    // Exit choice: among the exits the category can reach (or the farthest one if none),
+    // minimise seconds on the runway plus taxi seconds from the exit to the gate, never
+    // picking an exit that cannot taxi to the gate while another one can
+    int gateCount = config.gateCount;
+    config.exitChoices.assign(config.runways.size() * NUM_AIRCRAFT_CATEGORIES * (gateCount + 1), {0, 0, UNREACHABLE_TAXI});
+    for (size_t r = 0; r < config.runways.size(); ++r) {
+        std::vector<const Exit*> runwayExits;
+        for (const auto& exit : exits) {
+            if (exit.runwayId == config.runways[r].id) runwayExits.push_back(&exit);
+        }
+        if (runwayExits.empty()) continue;
+        std::vector<std::vector<int>> exitDistances;
+        for (const Exit* exit : runwayExits) {
+            ensureNode(exit->node);
+            exitDistances.push_back(taxiDistancesFrom(exit->node, edges));
+        }
+        for (int c = 0; c < NUM_AIRCRAFT_CATEGORIES; ++c) {
+            int rollout = CATEGORY_PROFILES[c].rolloutMeters;
+            size_t farthest = 0;
+            bool anyReachable = false;
+            for (size_t e = 0; e < runwayExits.size(); ++e) {
+                if (runwayExits[e]->distance > runwayExits[farthest]->distance) farthest = e;
+                if (runwayExits[e]->distance >= rollout) anyReachable = true;
+            }
+            for (int g = 0; g <= gateCount; ++g) {
+                int gateNode = g == 0 ? -1 : gateNodes[g - 1];
+                auto candidate = [&](size_t e) {
+                    return anyReachable ? runwayExits[e]->distance >= rollout : e == farthest;
+                };
+                auto taxiFrom = [&](size_t e) {
+                    return gateNode >= 0 && gateNode < static_cast<int>(exitDistances[e].size())
+                               ? exitDistances[e][gateNode] : INT32_MAX;
+                };
+                // With a known gate, an exit that cannot taxi there only wins if no exit can
+                bool gateReachable = false;
+                for (size_t e = 0; e < runwayExits.size(); ++e) {
+                    if (candidate(e) && taxiFrom(e) < UNREACHABLE_TAXI) gateReachable = true;
+                }
+                double bestCost = 1e300;
+                ExitChoice best = {0, 0, UNREACHABLE_TAXI};
+                for (size_t e = 0; e < runwayExits.size(); ++e) {
+                    if (!candidate(e)) continue;
+                    int taxi = taxiFrom(e);
+                    if (gateReachable && taxi >= UNREACHABLE_TAXI) continue;
+                    double cost = runwayExits[e]->occupancyPercent / 100.0 * config.runways[r].occupancyMs / 1000.0;
+                    if (taxi < UNREACHABLE_TAXI) cost += taxi;
+                    else if (gateNode >= 0) cost += UNREACHABLE_TAXI;
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        best = {static_cast<uint8_t>(runwayExits[e]->occupancyPercent), static_cast<uint8_t>(e),
+                                static_cast<uint16_t>(taxi < UNREACHABLE_TAXI ? taxi : UNREACHABLE_TAXI)};
+                    }
                 }
+                config.exitChoices[exitChoiceIndex(r, static_cast<AircraftCategory>(c), g, gateCount)] = best;
             }
-            if (allRunwaysFree) break;
         }
     }
+    return true;
 }
-int main() {
-    int numRunways, numFlights;
-    std::cout << "Enter the number of runways: ";
-    std::cin >> numRunways;
 
-    // Initialize the runways
-    for (int i = 0; i < numRunways; ++i) {
-        runways.emplace_back(i + 1); // Runway IDs start from 1
+// Compiled configuration image: a fixed header followed by the runway records and the
+// gate-to-runway taxi matrix, laid out exactly as they are read so startup is a single
+// mmap plus a copy of each section.
+struct AirportImageHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t runwayCount;
+    uint64_t runwayOffset;
+    uint32_t gateCount;
+    uint32_t reserved;
+    uint64_t taxiOffset;
+    uint32_t occupancyModelCount;
+    uint32_t reserved2;
+    uint64_t occupancyModelOffset; // each model is an OccupancyRecord followed by its bins
+    uint64_t exitChoiceOffset;     // runwayCount x categories x (gateCount + 1) ExitChoice
+};
+
+struct OccupancyRecord {
+    int32_t runwayId;
+    int32_t kind;
+    float sigma;
+    int32_t binCount;
+};
+
+constexpr uint64_t AIRPORT_IMAGE_MAGIC = 0x414d53434f4e4631ULL; // "AMSCONF1"
+constexpr uint32_t AIRPORT_IMAGE_VERSION = 4;
+
+bool writeAirportImage(const std::string& path, const AirportConfig& config) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    uint64_t runwayBytes = config.runways.size() * sizeof(RunwayConfig);
+    uint64_t taxiBytes = config.taxiSeconds.size() * sizeof(uint16_t);
+    uint64_t exitBytes = config.exitChoices.size() * sizeof(ExitChoice);
+    AirportImageHeader header = {AIRPORT_IMAGE_MAGIC, AIRPORT_IMAGE_VERSION,
+                                 static_cast<uint32_t>(config.runways.size()), sizeof(AirportImageHeader),
+                                 static_cast<uint32_t>(config.gateCount), 0,
+                                 sizeof(AirportImageHeader) + runwayBytes,
+                                 static_cast<uint32_t>(config.occupancyModels.size()), 0,
+                                 sizeof(AirportImageHeader) + runwayBytes + taxiBytes + exitBytes,
+                                 sizeof(AirportImageHeader) + runwayBytes + taxiBytes};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(config.runways.data()), runwayBytes);
+    file.write(reinterpret_cast<const char*>(config.taxiSeconds.data()), taxiBytes);
+    file.write(reinterpret_cast<const char*>(config.exitChoices.data()), exitBytes);
+    for (const auto& model : config.occupancyModels) {
+        OccupancyRecord record = {model.runwayId, static_cast<int32_t>(model.kind), model.sigma,
+                                  static_cast<int32_t>(model.bins.size())};
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        file.write(reinterpret_cast<const char*>(model.bins.data()), model.bins.size() * sizeof(OccupancyBin));
     }
+    return static_cast<bool>(file);
+}
 
-    std::cout << "Enter the number of flights: ";
-    std::cin >> numFlights;
-    std::vector<Flight> flights;
+bool loadAirportImage(const std::string& path, AirportConfig& config) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(AirportImageHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) return false;
 
-    // Input flight details
-    for (int i = 0; i < numFlights; ++i) {
-        int id, priority;
-        std::string type, time;
-        std::cout << "Enter flight ID, type (arrival/departure), priority, and time: ";
-        std::cin >> id >> type >> priority >> time;
+    const auto* header = static_cast<const AirportImageHeader*>(addr);
+    const char* base = static_cast<const char*>(addr);
+    uint64_t taxiCount = static_cast<uint64_t>(header->gateCount) * header->runwayCount;
+    uint64_t exitCount = static_cast<uint64_t>(header->runwayCount) * NUM_AIRCRAFT_CATEGORIES * (header->gateCount + 1ULL);
+    bool valid = header->magic == AIRPORT_IMAGE_MAGIC && header->version == AIRPORT_IMAGE_VERSION &&
+                 header->runwayOffset + header->runwayCount * sizeof(RunwayConfig) <= size &&
+                 header->taxiOffset + taxiCount * sizeof(uint16_t) <= size &&
+                 header->exitChoiceOffset + exitCount * sizeof(ExitChoice) <= size;
+    // Sections follow each other unpadded, so one may sit at any alignment (the records
+    // after an odd-sized taxi matrix do): copy them out rather than cast in place
+    auto copySection = [base](auto& out, uint64_t offset, uint64_t count) {
+        out.resize(count);
+        if (count > 0) std::memcpy(out.data(), base + offset, count * sizeof(out[0]));
+    };
+    if (valid) {
+        copySection(config.runways, header->runwayOffset, header->runwayCount);
+        config.gateCount = header->gateCount;
+        copySection(config.taxiSeconds, header->taxiOffset, taxiCount);
+        copySection(config.exitChoices, header->exitChoiceOffset, exitCount);
 
-        Flight flight(id, type, priority, time);
-        flights.push_back(flight);
+        config.occupancyModels.clear();
+        uint64_t offset = header->occupancyModelOffset;
+        for (uint32_t m = 0; valid && m < header->occupancyModelCount; ++m) {
+            if (offset + sizeof(OccupancyRecord) > size) {
+                valid = false;
+                break;
+            }
+            OccupancyRecord record;
+            std::memcpy(&record, base + offset, sizeof(record));
+            offset += sizeof(OccupancyRecord);
+            if (record.binCount < 0 || offset + record.binCount * sizeof(OccupancyBin) > size) {
+                valid = false;
+                break;
+            }
+            OccupancyDistributionConfig model{record.runwayId, static_cast<OccupancyKind>(record.kind), record.sigma, {}};
+            copySection(model.bins, offset, record.binCount);
+            offset += record.binCount * sizeof(OccupancyBin);
+            config.occupancyModels.push_back(std::move(model));
+        }
     }
+    ::munmap(addr, size);
+    return valid;
+}
 
-    // Launch a thread to monitor and handle waiting flights
-    std::thread monitorThread(checkWaitingFlights);
+// Dense index for a thread while it is pinned or retiring in any EpochDomain, shared by
+// every domain so that nested pins across domains use the same slot. A thread holds its
+// slot only for the duration of those calls, so the limit is on threads inside an
+// epoch section at once, not on threads alive (affine dispatch alone may start hundreds).
+// A thread asks for the slot it last used first; when every slot is taken, it blocks
+// until a holder leaves its section.
+constexpr int MAX_EPOCH_THREADS = 256;
+std::atomic<bool> epochThreadInUse[MAX_EPOCH_THREADS];
+std::atomic<int> epochRegistryWaiters{0};
+std::mutex epochRegistryMutex;
+std::condition_variable epochSlotFreed;
 
-    // Process each flight based on type
-    std::vector<std::thread> flightThreads; // Store threads for each flight to handle concurrency
+struct EpochThreadRegistration {
+    int index = -1;
+    int preferred = 0; // the slot this thread held last
+    int depth = 0;     // nested acquisitions
+};
+thread_local EpochThreadRegistration epochRegistration;
 
-    for (auto& flight : flights) {
-        if (flight.type == "arrival") {
-            // Assign landing using a thread for each flight
-            flightThreads.emplace_back(assignLanding, std::ref(flight));
-        } else if (flight.type == "departure") {
-            // Placeholder for departure handling logic
-            flightThreads.emplace_back([](Flight f) {
-                std::cout << "Takeoff Flight ID: " << f.id << " assigned to runway (to be implemented)." << std::endl;
-                // Departure handling logic can go here
-            }, flight);
+int acquireEpochThreadIndex() {
+    EpochThreadRegistration& registration = epochRegistration;
+    if (registration.depth++ > 0) return registration.index;
+    auto claim = [&registration] {
+        for (int n = 0; n < MAX_EPOCH_THREADS; ++n) {
+            int i = (registration.preferred + n) % MAX_EPOCH_THREADS;
+            bool expected = false;
+            if (epochThreadInUse[i].compare_exchange_strong(expected, true)) return i;
         }
+        return -1;
+    };
+    if ((registration.index = claim()) < 0) {
+        std::unique_lock<std::mutex> lock(epochRegistryMutex);
+        epochRegistryWaiters.fetch_add(1);
+        epochSlotFreed.wait(lock, [&] { return (registration.index = claim()) >= 0; });
+        epochRegistryWaiters.fetch_sub(1);
     }
+    registration.preferred = registration.index;
+    return registration.index;
+}
 
-    // Wait for all flight assignment threads to finish
-    for (auto& th : flightThreads) {
-        if (th.joinable()) th.join();
+void releaseEpochThreadIndex() {
+    EpochThreadRegistration& registration = epochRegistration;
+    if (--registration.depth > 0) return;
+    epochThreadInUse[registration.index].store(false);
+    registration.index = -1;
+    // Ordered after the store above, so a waiter either sees the slot free or is counted
+    if (epochRegistryWaiters.load() > 0) {
+        { std::lock_guard<std::mutex> lock(epochRegistryMutex); }
+        epochSlotFreed.notify_all();
     }
+}
 
-    // Signal the monitor thread to stop checking once all flights are processed
-    monitorThread.join();
+// Epoch-based reclamation for objects published through an atomic pointer. Readers pin
+// the current epoch while they dereference the pointer; a retired object is freed once
+// every pinned reader has moved past the epoch it was retired in.
+//
+// Retirements collect in the batch of the registry slot the retiring thread holds and
+// are handed to the shared list BATCH_SIZE at a time, advancing the epoch once per
+// batch. At most MAX_PENDING objects wait for reclamation: past that, a retiring thread
+// that is not itself pinned waits for readers to move on before returning.
+class EpochDomain {
+public:
+    static constexpr size_t BATCH_SIZE = 32;
+    static constexpr size_t MAX_PENDING = 4096;
 
-    // Check if all runways are available and queues are empty before exiting
-    while (true) {
-        bool allFree = true;
-        for (const auto& runway : runways) {
-            if (!runway.isAvailable) {
-                allFree = false;
-                break;
+    class Guard {
+    public:
+        explicit Guard(std::atomic<uint64_t>* slot) : slot(slot) {}
+        Guard(Guard&& other) noexcept : slot(other.slot) { other.slot = nullptr; }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard() {
+            if (!slot) return;
+            slot->store(0, std::memory_order_release);
+            releaseEpochThreadIndex();
+        }
+
+    private:
+        std::atomic<uint64_t>* slot;
+    };
+
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // Nothing can be pinned once the domain itself goes away
+    ~EpochDomain() {
+        for (auto& thread : threads) {
+            for (auto& entry : thread.batch) entry.deleter();
+        }
+        for (auto& entry : retired) entry.deleter();
+    }
+
+    Guard pin() {
+        std::atomic<uint64_t>* slot = &threads[acquireEpochThreadIndex()].epoch;
+        slot->store(globalEpoch.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+        // The reader's next loads must not move ahead of the pin, or a reclaim that missed
+        // the pin could free what they return
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return Guard(slot);
+    }
+
+    // Schedules `deleter` to run once no reader can still see the retired object
+    void retire(std::function<void()> deleter) {
+        ThreadSlot& thread = threads[acquireEpochThreadIndex()];
+        bool full;
+        {
+            std::lock_guard<std::mutex> lock(thread.batchMutex);
+            thread.batch.push_back({globalEpoch.load(std::memory_order_seq_cst), std::move(deleter)});
+            full = thread.batch.size() >= BATCH_SIZE;
+        }
+        bool over = pending.fetch_add(1, std::memory_order_relaxed) + 1 > MAX_PENDING &&
+                    thread.epoch.load(std::memory_order_relaxed) == 0;
+        if (!over && full) {
+            std::lock_guard<std::mutex> lock(retireMutex);
+            publishBatch(thread);
+            reclaim();
+        }
+        // Give the registry slot back before waiting, so readers are never short of one
+        releaseEpochThreadIndex();
+        if (over) {
+            while (pending.load(std::memory_order_relaxed) > MAX_PENDING) {
+                tryReclaim();
+                if (pending.load(std::memory_order_relaxed) > MAX_PENDING) std::this_thread::yield();
             }
         }
+    }
 
-        if (preemptedFlights.empty() && regularFlights.empty() && allFree) {
-            std::cout << "All flights have landed or taken off. Exiting system." << std::endl;
-            break;
+    // Hands every thread's batch to the shared list and frees what no reader can see
+    void tryReclaim() {
+        std::lock_guard<std::mutex> lock(retireMutex);
+        for (auto& thread : threads) publishBatch(thread);
+        reclaim();
+    }
+
+    size_t pendingCount() const { return pending.load(std::memory_order_relaxed); }
+
+private:
+    struct Retired {
+        uint64_t epoch;
+        std::function<void()> deleter;
+    };
+
+    struct alignas(64) ThreadSlot {
+        std::atomic<uint64_t> epoch{0}; // 0 when the thread is not pinned
+        std::mutex batchMutex;          // uncontended except while the batch is published
+        std::vector<Retired> batch;
+    };
+
+    std::atomic<uint64_t> globalEpoch{1};
+    std::atomic<size_t> pending{0};
+    ThreadSlot threads[MAX_EPOCH_THREADS];
+    std::mutex retireMutex; // guards `retired`
+    std::vector<Retired> retired;
+
+    // Caller holds retireMutex
+    void publishBatch(ThreadSlot& thread) {
+        std::lock_guard<std::mutex> lock(thread.batchMutex);
+        if (thread.batch.empty()) return;
+        std::move(thread.batch.begin(), thread.batch.end(), std::back_inserter(retired));
+        thread.batch.clear();
+        // Readers pinning from now on are past everything in this batch
+        globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // Caller holds retireMutex
+    void reclaim() {
+        uint64_t oldestPinned = UINT64_MAX;
+        for (const auto& thread : threads) {
+            uint64_t epoch = thread.epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0 && epoch < oldestPinned) oldestPinned = epoch;
+        }
+        size_t freed = 0;
+        auto keep = retired.begin();
+        for (auto it = retired.begin(); it != retired.end(); ++it) {
+            if (it->epoch < oldestPinned) {
+                it->deleter();
+                ++freed;
+            } else {
+                *keep++ = std::move(*it);
+            }
         }
+        retired.erase(keep, retired.end());
+        pending.fetch_sub(freed, std::memory_order_relaxed);
     }
+};
 
-    return 0;
-}
\ No newline at end of file
+// Configuration the dispatcher reads on every assignment. It is immutable once
+// published; a reload builds a new one and swaps the pointer.
+struct LiveConfig {
+    std::vector<int32_t> occupancyMs; // per runway slot, 0 if the runway is closed
+    int32_t gateCount = 0;
+    std::vector<uint16_t> taxiSeconds; // gateCount rows of one entry per runway slot
+    std::vector<OccupancyModel> occupancyModels; // per runway slot
+    std::vector<ExitChoice> exitChoices; // slotCount x categories x (gateCount + 1)
+
+    const ExitChoice& exitFor(size_t slot, const Flight& flight) const {
+        int gate = flight.gate >= 1 && flight.gate <= gateCount ? flight.gate : 0;
+        return exitChoices[exitChoiceIndex(slot, flight.category, gate, gateCount)];
+    }
+};
+
+std::atomic<const LiveConfig*> liveConfig{nullptr};
+EpochDomain configEpochs;
+
+// Maps configured runway ids onto the preallocated runway slots (id N is slot N-1).
+// Returns nullptr if a runway id does not fit.
+LiveConfig* buildLiveConfig(const AirportConfig& config, size_t slotCount) {
+    auto* live = new LiveConfig;
+    live->occupancyMs.assign(slotCount, 0);
+    for (const auto& runway : config.runways) {
+        if (runway.id < 1 || static_cast<size_t>(runway.id) > slotCount || runway.occupancyMs <= 0) {
+            delete live;
+            return nullptr;
+        }
+        live->occupancyMs[runway.id - 1] = runway.occupancyMs;
+    }
+    live->occupancyModels.resize(slotCount);
+    for (size_t i = 0; i < slotCount; ++i) {
+        live->occupancyModels[i] = OccupancyModel(OccupancyKind::Fixed, live->occupancyMs[i], 0, {});
+    }
+    for (const auto& model : config.occupancyModels) {
+        if (model.runwayId < 1 || static_cast<size_t>(model.runwayId) > slotCount) continue;
+        size_t slot = model.runwayId - 1;
+        live->occupancyModels[slot] = OccupancyModel(model.kind, live->occupancyMs[slot], model.sigma, model.bins);
+    }
+    // Re-index the taxi matrix and exit choices from configuration order to runway slots
+    live->gateCount = config.gateCount;
+    live->exitChoices.assign(slotCount * NUM_AIRCRAFT_CATEGORIES * (config.gateCount + 1), {0, 0, UNREACHABLE_TAXI});
+    if (!config.exitChoices.empty()) {
+        for (size_t r = 0; r < config.runways.size(); ++r) {
+            for (int c = 0; c < NUM_AIRCRAFT_CATEGORIES; ++c) {
+                for (int g = 0; g <= config.gateCount; ++g) {
+                    auto category = static_cast<AircraftCategory>(c);
+                    live->exitChoices[exitChoiceIndex(config.runways[r].id - 1, category, g, config.gateCount)] =
+                        config.exitChoices[exitChoiceIndex(r, category, g, config.gateCount)];
+                }
+            }
+        }
+    }
+    live->taxiSeconds.assign(static_cast<size_t>(config.gateCount) * slotCount, UNREACHABLE_TAXI);
+    for (int32_t g = 0; g < config.gateCount; ++g) {
+        for (size_t r = 0; r < config.runways.size(); ++r) {
+            live->taxiSeconds[g * slotCount + config.runways[r].id - 1] =
+                config.taxiSeconds[g * config.runways.size() + r];
+        }
+    }
+    return live;
+}
+
+// Publishes a new configuration and retires the previous one
+void publishLiveConfig(const LiveConfig* config) {
+    const LiveConfig* previous = liveConfig.exchange(config, std::memory_order_acq_rel);
+    if (previous) configEpochs.retire([previous] { delete previous; });
+}
+
+std::vector<Runway> runways;
+std::mutex flightsMutex;
+
+// Runway capacity share per airline; airlines not listed get weight 1.
+// Filled in by main() before any flight is submitted.
+std::map<std::string, double> airlineWeights;
+
+double airlineWeight(const std::string& airline) {
+    auto it = airlineWeights.find(airline);
+    return it == airlineWeights.end() ? 1.0 : it->second;
+}
+
+// Per-airline dispatch statistics, guarded by runwayMutex
+struct AirlineStats {
+    long long dispatched = 0;
+    long long totalDelayMs = 0;
+    double weightedDelayMs = 0; // each delay weighted by 1 / priority
+    double totalWeight = 0;
+};
+std::map<std::string, AirlineStats> airlineStats;
+
+class FairQueue;
+
+// A flight's record in the flight store, indexed by Flight::handle. The queue links live
+// in the record itself, so queueing, dequeueing and cancelling a flight rewire a few
+// indices and never allocate or copy the Flight.
+struct FlightRecord {
+    Flight flight{0, "", 0, ""};
+    std::atomic<uint8_t> state{0};    // FlightState, driven by the status board
+    std::atomic<int> generation{0};   // bumped each time the slot is reused
+    std::atomic<int> nextFree{-1};    // link while the slot is on the free list
+    const FairQueue* queue = nullptr; // the queue currently linking this record
+    int lane = -1;
+    int prev = -1;
+    int next = -1;
+    double finish = 0;
+    unsigned long long sequence = 0; // breaks ties between equal tags in arrival order
+    long long queuedMs = 0;
+};
+
+// Flight records by handle. Chunks of CHUNK_SIZE records hang off a fixed segment table
+// and are never moved or freed while the store lives, so looking up any handle, even a
+// stale one, is safe and costs two loads. Producers append without taking a lock: a slot
+// comes from the free list, or else from a shared counter, and the first producer to
+// reach an empty segment installs its chunk with a compare-and-swap.
+//
+// Slots are reused, so a handle carries the slot's generation in its high bits and
+// current() tells whether it still names the flight it was issued for; code that keeps
+// handles past the lock it found them under (a published RecommendedSequence, say)
+// checks current() before trusting one. A released slot goes back on the free list only
+// after every reader pinned at release time has unpinned. So a reader that pins the
+// store and then takes a handle from wherever the owner drops it before release()
+// may read that record without runwayMutex until it unpins; a handle obtained before
+// pinning gives no such guarantee, whatever current() says.
+class FlightStore {
+public:
+    static constexpr int CHUNK_BITS = 10;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_BITS;
+    static constexpr int MAX_CHUNKS = 1024;
+    static constexpr int CAPACITY = CHUNK_SIZE * MAX_CHUNKS;
+    static constexpr int SLOT_BITS = 20; // CAPACITY == 1 << SLOT_BITS
+    static constexpr int GENERATIONS = 1 << (31 - SLOT_BITS);
+    static_assert(CAPACITY == 1 << SLOT_BITS, "slot bits must cover the store");
+
+    static int slotOf(int handle) { return handle & (CAPACITY - 1); }
+
+    // Copies `flight` into a free slot and returns its handle, or -1 when the store is full
+    int append(const Flight& flight) {
+        int slot = popFree();
+        if (slot < 0) {
+            slot = nextSlot.load(std::memory_order_relaxed);
+            do {
+                if (slot >= CAPACITY) return -1;
+            } while (!nextSlot.compare_exchange_weak(slot, slot + 1, std::memory_order_relaxed));
+            installChunk(slot >> CHUNK_BITS);
+        }
+        // The queue links were reset when the slot was unlinked; they belong to runwayMutex
+        FlightRecord& entry = record(slot);
+        int handle = entry.generation.load(std::memory_order_relaxed) << SLOT_BITS | slot;
+        entry.flight = flight;
+        entry.flight.handle = handle;
+        return handle;
+    }
+
+    FlightRecord& record(int handle) {
+        int slot = slotOf(handle);
+        return chunks[slot >> CHUNK_BITS].load(std::memory_order_acquire)[slot & (CHUNK_SIZE - 1)];
+    }
+
+    const FlightRecord& record(int handle) const {
+        int slot = slotOf(handle);
+        return chunks[slot >> CHUNK_BITS].load(std::memory_order_acquire)[slot & (CHUNK_SIZE - 1)];
+    }
+
+    // True while `handle` names a live or not yet recycled flight. A slot reused
+    // GENERATIONS times while a stale handle is still held would match again.
+    bool current(int handle) const {
+        return handle >= 0 && slotOf(handle) < highWater() &&
+               record(handle).generation.load(std::memory_order_acquire) == handle >> SLOT_BITS;
+    }
+
+    // One past the highest slot ever handed out
+    int highWater() const { return nextSlot.load(std::memory_order_acquire); }
+
+    // Returns the slot for reuse once no pinned reader can still be looking at it.
+    // The record must already be out of every queue.
+    void release(int handle) {
+        if (handle >= 0) epochs.retire([this, handle] { pushFree(handle); });
+    }
+
+    EpochDomain::Guard pin() { return epochs.pin(); }
+
+    // Released slots not yet back on the free list
+    size_t pendingReleases() const { return epochs.pendingCount(); }
+
+private:
+    std::atomic<FlightRecord*> chunks[MAX_CHUNKS] = {};
+    std::unique_ptr<FlightRecord[]> owned[MAX_CHUNKS]; // set only by the thread that installed the chunk
+    std::atomic<int> nextSlot{0};
+    std::atomic<uint64_t> freeHead{0}; // (ABA tag << 32) | (slot + 1), low word 0 when empty
+    EpochDomain epochs;                // destroyed first, while the chunks are still there
+
+    void installChunk(int chunk) {
+        if (chunks[chunk].load(std::memory_order_acquire)) return;
+        FlightRecord* fresh = new FlightRecord[CHUNK_SIZE];
+        FlightRecord* expected = nullptr;
+        if (chunks[chunk].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+            owned[chunk].reset(fresh);
+        } else {
+            delete[] fresh;
+        }
+    }
+
+    static uint64_t freeWord(uint64_t head, int slot) {
+        return ((head >> 32) + 1) << 32 | static_cast<uint32_t>(slot + 1);
+    }
+
+    // Retires the handle's generation, then links its slot onto the free list
+    void pushFree(int handle) {
+        int slot = slotOf(handle);
+        FlightRecord& entry = record(slot);
+        entry.generation.store(((handle >> SLOT_BITS) + 1) & (GENERATIONS - 1), std::memory_order_release);
+        uint64_t head = freeHead.load(std::memory_order_relaxed);
+        do {
+            entry.nextFree.store(static_cast<int>(head & 0xffffffffu) - 1, std::memory_order_relaxed);
+        } while (!freeHead.compare_exchange_weak(head, freeWord(head, slot), std::memory_order_release,
+                                                 std::memory_order_relaxed));
+    }
+
+    int popFree() {
+        uint64_t head = freeHead.load(std::memory_order_acquire);
+        while ((head & 0xffffffffu) != 0) {
+            int slot = static_cast<int>(head & 0xffffffffu) - 1;
+            int next = record(slot).nextFree.load(std::memory_order_relaxed);
+            if (freeHead.compare_exchange_weak(head, freeWord(head, next), std::memory_order_acquire,
+                                               std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+        return -1;
+    }
+};
+
+FlightStore flightStore;
+
+// Flight lifecycle state, kept in each flight's store record. Transitions are
+// compare-and-swap from the expected state, so a transition from the wrong state (or
+// one the table forbids) fails instead of overwriting; reads never take a lock. The
+// per-state totals are kept as flights move, so they survive slot reuse.
+class FlightStatusBoard {
+public:
+    // Starts tracking a freshly appended flight as Scheduled
+    void track(int handle) {
+        flightStore.record(handle).state.store(static_cast<uint8_t>(FlightState::Scheduled), std::memory_order_release);
+        counts[static_cast<int>(FlightState::Scheduled)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool transition(int handle, FlightState from, FlightState to) {
+        if (!flightStore.current(handle)) return false;
+        if (!(ALLOWED_TRANSITIONS[static_cast<int>(from)] & stateBit(to))) {
+            rejectedTransitions.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        uint8_t expected = static_cast<uint8_t>(from);
+        if (flightStore.record(handle).state.compare_exchange_strong(expected, static_cast<uint8_t>(to),
+                                                                     std::memory_order_acq_rel)) {
+            counts[static_cast<int>(from)].fetch_sub(1, std::memory_order_relaxed);
+            counts[static_cast<int>(to)].fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        rejectedTransitions.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    FlightState state(int handle) const {
+        return static_cast<FlightState>(flightStore.record(handle).state.load(std::memory_order_acquire));
+    }
+
+    long long count(FlightState state) const { return counts[static_cast<int>(state)].load(); }
+
+    void printCounts() const {
+        std::cout << "Flight states:";
+        for (int st = 0; st < NUM_FLIGHT_STATES; ++st) {
+            long long count = counts[st].load();
+            if (count > 0) std::cout << " " << FLIGHT_STATE_NAMES[st] << " " << count;
+        }
+        long long rejected = rejectedTransitions.load();
+        if (rejected > 0) std::cout << " (" << rejected << " invalid transitions refused)";
+        std::cout << std::endl;
+    }
+
+private:
+    std::atomic<long long> counts[NUM_FLIGHT_STATES] = {};
+    std::atomic<long long> rejectedTransitions{0};
+};
+
+FlightStatusBoard flightStatus;
+
+// Weighted fair queue over airlines. Each airline has its own FIFO lane; a flight's
+// virtual finish tag is max(virtual time, lane's last tag) + 1 / weight, and the lane
+// whose head has the smallest tag goes next. Lanes are intrusive lists threaded through
+// the flight store records and their heads sit in an indexed min-heap, so push, pop and removal
+// of any queued flight cost O(log A) over A airlines and allocate nothing once every
+// airline has been seen.
+class FairQueue {
+public:
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    // Links the flight's store record onto the tail of its airline's lane
+    void push_back(const Flight& flight) {
+        int laneId = laneFor(flight.airline);
+        Lane& lane = lanes[laneId];
+        FlightRecord& record = flightStore.record(flight.handle);
+        record.finish = std::max(virtualTime, lane.lastFinish) + 1.0 / airlineWeight(flight.airline);
+        lane.lastFinish = record.finish;
+        record.sequence = nextSequence++;
+        record.queuedMs = nowMs();
+        record.queue = this;
+        record.lane = laneId;
+        record.prev = lane.tail;
+        record.next = -1;
+        if (lane.tail >= 0) {
+            flightStore.record(lane.tail).next = flight.handle;
+        } else {
+            lane.head = flight.handle;
+            heapInsert(laneId);
+        }
+        lane.tail = flight.handle;
+        ++count;
+    }
+
+    // False for a stale handle even when its slot now holds another flight queued here
+    bool contains(int handle) const {
+        return flightStore.current(handle) && flightStore.record(handle).queue == this;
+    }
+
+    // The queued flight `handle` names; only meaningful when contains(handle)
+    const Flight& find(int handle) const { return flightStore.record(handle).flight; }
+
+    const Flight& front() const { return flightStore.record(lanes[heap.front()].head).flight; }
+
+    // Removes the next flight and charges its queueing delay to its airline
+    void pop_front() {
+        int handle = lanes[heap.front()].head;
+        virtualTime = flightStore.record(handle).finish;
+        chargeDelay(flightStore.record(handle));
+        unlink(handle);
+    }
+
+    // Removes a specific queued flight out of fair-share order, as pop_front() would
+    Flight take(int handle) {
+        chargeDelay(flightStore.record(handle));
+        unlink(handle);
+        return flightStore.record(handle).flight;
+    }
+
+    // Appends up to `limit` handles to `out` in the order pop_front() would hand them
+    // out, merging the lane prefixes; O(limit x A) over A airlines
+    void peekInOrder(size_t limit, std::vector<int>& out) const {
+        cursors.resize(lanes.size());
+        for (size_t l = 0; l < lanes.size(); ++l) cursors[l] = lanes[l].head;
+        for (size_t taken = 0; taken < limit && taken < count; ++taken) {
+            int next = -1;
+            for (size_t l = 0; l < lanes.size(); ++l) {
+                if (cursors[l] >= 0 && (next < 0 || tagBefore(cursors[l], cursors[next]))) next = static_cast<int>(l);
+            }
+            out.push_back(cursors[next]);
+            cursors[next] = flightStore.record(cursors[next]).next;
+        }
+    }
+
+    // The queued flight with the lowest priority (highest number), or nullptr
+    const Flight* lowestPriority() const {
+        const Flight* lowest = nullptr;
+        forEach([&lowest](const Flight& flight) {
+            if (!lowest || flight.priority > lowest->priority) lowest = &flight;
+        });
+        return lowest;
+    }
+
+    void erase(int handle) {
+        if (contains(handle)) unlink(handle);
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        for (const Lane& lane : lanes) {
+            for (int handle = lane.head; handle >= 0; handle = flightStore.record(handle).next) {
+                visit(flightStore.record(handle).flight);
+            }
+        }
+    }
+
+    void clear() {
+        for (Lane& lane : lanes) {
+            while (lane.head >= 0) {
+                FlightRecord& record = flightStore.record(lane.head);
+                lane.head = record.next;
+                record.queue = nullptr;
+                record.lane = record.prev = record.next = -1;
+            }
+            lane.tail = -1;
+            lane.heapPos = -1;
+        }
+        heap.clear();
+        count = 0;
+    }
+
+private:
+    struct Lane {
+        int head = -1;
+        int tail = -1;
+        int heapPos = -1; // position in `heap`, -1 while the lane is empty
+        double lastFinish = 0;
+    };
+
+    std::vector<Lane> lanes;
+    std::unordered_map<std::string, int> laneOf; // airline -> index into lanes
+    std::vector<int> heap;                       // non-empty lanes, ordered by their head's tag
+    mutable std::vector<int> cursors;            // per-lane scratch for peekInOrder
+    double virtualTime = 0;
+    unsigned long long nextSequence = 0;
+    size_t count = 0;
+
+    int laneFor(const std::string& airline) {
+        auto it = laneOf.find(airline);
+        if (it != laneOf.end()) return it->second;
+        lanes.emplace_back();
+        heap.reserve(lanes.size());
+        return laneOf[airline] = static_cast<int>(lanes.size()) - 1;
+    }
+
+    void unlink(int handle) {
+        FlightRecord& record = flightStore.record(handle);
+        int laneId = record.lane;
+        Lane& lane = lanes[laneId];
+        bool head = lane.head == handle;
+        if (record.prev >= 0) flightStore.record(record.prev).next = record.next; else lane.head = record.next;
+        if (record.next >= 0) flightStore.record(record.next).prev = record.prev; else lane.tail = record.prev;
+        record.queue = nullptr;
+        record.lane = record.prev = record.next = -1;
+        --count;
+        if (!head) return;
+        if (lane.head < 0) {
+            heapRemove(laneId);
+        } else {
+            siftDown(lane.heapPos); // the new head's tag is never smaller
+        }
+    }
+
+    static void chargeDelay(const FlightRecord& record) {
+        AirlineStats& stats = airlineStats[record.flight.airline];
+        long long delayMs = nowMs() - record.queuedMs;
+        double weight = 1.0 / std::max(record.flight.priority, 1);
+        ++stats.dispatched;
+        stats.totalDelayMs += delayMs;
+        stats.weightedDelayMs += weight * delayMs;
+        stats.totalWeight += weight;
+    }
+
+    static bool tagBefore(int a, int b) {
+        const FlightRecord& x = flightStore.record(a);
+        const FlightRecord& y = flightStore.record(b);
+        return x.finish != y.finish ? x.finish < y.finish : x.sequence < y.sequence;
+    }
+
+    bool headBefore(int a, int b) const { return tagBefore(lanes[a].head, lanes[b].head); }
+
+    void place(size_t pos, int laneId) {
+        heap[pos] = laneId;
+        lanes[laneId].heapPos = static_cast<int>(pos);
+    }
+
+    void heapInsert(int laneId) {
+        heap.push_back(laneId);
+        lanes[laneId].heapPos = static_cast<int>(heap.size()) - 1;
+        siftUp(heap.size() - 1);
+    }
+
+    void heapRemove(int laneId) {
+        size_t pos = lanes[laneId].heapPos;
+        lanes[laneId].heapPos = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if (pos == heap.size()) return;
+        place(pos, last);
+        siftUp(pos);
+        siftDown(lanes[last].heapPos);
+    }
+
+    void siftUp(size_t pos) {
+        int laneId = heap[pos];
+        while (pos > 0 && headBefore(laneId, heap[(pos - 1) / 2])) {
+            place(pos, heap[(pos - 1) / 2]);
+            pos = (pos - 1) / 2;
+        }
+        place(pos, laneId);
+    }
+
+    void siftDown(size_t pos) {
+        int laneId = heap[pos];
+        for (;;) {
+            size_t child = 2 * pos + 1;
+            if (child >= heap.size()) break;
+            if (child + 1 < heap.size() && headBefore(heap[child + 1], heap[child])) ++child;
+            if (!headBefore(heap[child], laneId)) break;
+            place(pos, heap[child]);
+            pos = child;
+        }
+        place(pos, laneId);
+    }
+};
+
+FairQueue preemptedFlights;
+FairQueue regularFlights;
+
+std::mutex runwayMutex;
+std::condition_variable runwayAvailableCV;
+
+// Scheduler lifecycle. Running accepts flights. Draining accepts none and finishes the
+// queued and in-flight ones, cancelling whatever is still queued at the drain deadline.
+// Stopped once the monitor has seen every landing complete and joined its threads.
+enum class SchedulerState { Running, Draining, Stopped };
+std::atomic<SchedulerState> schedulerState{SchedulerState::Running};
+
+// Both guarded by runwayMutex
+std::optional<std::chrono::steady_clock::time_point> drainDeadline;
+int flightsCancelled = 0;
+
+// Counts flights accepted but not yet finished (landed, cancelled or shed), so "is all
+// work done" is a single load rather than a scan of queues and runways. Reaching zero
+// fires a completion event that waitAllDone() blocks on.
+class CompletionTracker {
+public:
+    void accepted() { outstanding.fetch_add(1, std::memory_order_relaxed); }
+
+    void completed() {
+        if (outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            doneCV.notify_all();
+        }
+    }
+
+    bool allDone() const { return outstanding.load(std::memory_order_acquire) == 0; }
+
+    // Only meaningful once intake has stopped; before that the count can touch zero
+    // between two submissions
+    void waitAllDone() {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCV.wait(lock, [this] { return allDone(); });
+    }
+
+private:
+    std::atomic<long long> outstanding{0};
+    std::mutex doneMutex;
+    std::condition_variable doneCV;
+};
+
+CompletionTracker completion;
+
+// Flights with priority at or below this value go to the preempted queue
+constexpr int PREEMPT_PRIORITY = 1;
+
+enum class PriorityClass { Preempted = 0, Regular = 1 };
+constexpr int NUM_PRIORITY_CLASSES = 2;
+
+PriorityClass priorityClassOf(const Flight& flight) {
+    return flight.priority <= PREEMPT_PRIORITY ? PriorityClass::Preempted : PriorityClass::Regular;
+}
+
+FairQueue& queueFor(PriorityClass cls) {
+    return cls == PriorityClass::Preempted ? preemptedFlights : regularFlights;
+}
+
+// What happens to a flight whose priority class queue is already full
+enum class AdmissionPolicy {
+    Reject,        // turn the new flight away
+    BlockProducer, // make the submitting thread wait for room
+    ShedLowest     // drop whichever of the new and queued flights has the lowest priority
+};
+
+class AdmissionController {
+public:
+    AdmissionPolicy policy;
+
+    AdmissionController(int preemptedCapacity, int regularCapacity, AdmissionPolicy policy)
+        : policy(policy), capacity{preemptedCapacity, regularCapacity} {}
+
+    // Must be called before any flight is submitted
+    void configure(int preemptedCapacity, int regularCapacity, AdmissionPolicy newPolicy) {
+        capacity[0] = preemptedCapacity;
+        capacity[1] = regularCapacity;
+        policy = newPolicy;
+    }
+
+    // Fast path: a single fetch_add reserves a queue slot
+    bool tryAcquire(PriorityClass cls) {
+        int c = static_cast<int>(cls);
+        if (depth[c].fetch_add(1, std::memory_order_acq_rel) < capacity[c]) return true;
+        depth[c].fetch_sub(1, std::memory_order_acq_rel);
+        return false;
+    }
+
+    // Called when a flight leaves its queue for a runway
+    void release(PriorityClass cls) {
+        int c = static_cast<int>(cls);
+        depth[c].fetch_sub(1, std::memory_order_acq_rel);
+        released[c].fetch_add(1, std::memory_order_relaxed);
+        if (policy == AdmissionPolicy::BlockProducer) {
+            std::lock_guard<std::mutex> lock(admissionMutex);
+            roomAvailableCV.notify_all();
+        }
+    }
+
+    // Slow path for BlockProducer: wait until a slot can be reserved
+    void acquireBlocking(PriorityClass cls) {
+        int c = static_cast<int>(cls);
+        std::unique_lock<std::mutex> lock(admissionMutex);
+        if (tryAcquire(cls)) return;
+        blocked[c].fetch_add(1, std::memory_order_relaxed);
+        roomAvailableCV.wait(lock, [this, cls] { return tryAcquire(cls); });
+    }
+
+    void recordRejected(PriorityClass cls) { rejected[static_cast<int>(cls)].fetch_add(1, std::memory_order_relaxed); }
+    // A queued (already admitted) flight was dropped to make room
+    void recordShed(PriorityClass cls) { shed[static_cast<int>(cls)].fetch_add(1, std::memory_order_relaxed); }
+
+    void printMetrics() const {
+        const char* names[NUM_PRIORITY_CLASSES] = {"preempted", "regular"};
+        for (int c = 0; c < NUM_PRIORITY_CLASSES; ++c) {
+            // Admissions are derived so the fast path stays a single atomic op
+            long long admitted = released[c].load() + depth[c].load() + shed[c].load();
+            std::cout << "Admission " << names[c] << ": admitted " << admitted
+                      << ", rejected " << rejected[c].load()
+                      << ", shed " << shed[c].load()
+                      << ", blocked " << blocked[c].load() << std::endl;
+        }
+    }
+
+private:
+    int capacity[NUM_PRIORITY_CLASSES];
+    std::atomic<int> depth[NUM_PRIORITY_CLASSES] = {};
+    std::atomic<long long> released[NUM_PRIORITY_CLASSES] = {};
+    std::atomic<long long> rejected[NUM_PRIORITY_CLASSES] = {};
+    std::atomic<long long> shed[NUM_PRIORITY_CLASSES] = {};
+    std::atomic<long long> blocked[NUM_PRIORITY_CLASSES] = {};
+
+    std::mutex admissionMutex;
+    std::condition_variable roomAvailableCV;
+};
+
+AdmissionController admission(256, 256, AdmissionPolicy::BlockProducer);
+
+// Append-only writer used for the journal and result files. Records are batched into
+// fixed buffers and a full buffer goes out as a single write. With AMS_WITH_IO_URING the
+// buffers are registered with an io_uring and written with asynchronous fixed-buffer
+// submissions; otherwise (or if ring setup fails) each batch is one pwrite().
+class EventSink {
+public:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+    static constexpr int NUM_BUFFERS = 2;
+
+    long long records = 0;
+    long long syscalls = 0;
+
+    EventSink() = default;
+    EventSink(const EventSink&) = delete;
+    EventSink& operator=(const EventSink&) = delete;
+
+    ~EventSink() { close(); }
+
+    bool open(const std::string& path) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        storage.assign(NUM_BUFFERS * BUFFER_SIZE, 0);
+#ifdef AMS_WITH_IO_URING
+        if (io_uring_queue_init(NUM_BUFFERS * 2, &ring, 0) == 0) {
+            iovec iov[NUM_BUFFERS];
+            for (int i = 0; i < NUM_BUFFERS; ++i) {
+                iov[i].iov_base = buffer(i);
+                iov[i].iov_len = BUFFER_SIZE;
+            }
+            if (io_uring_register_buffers(&ring, iov, NUM_BUFFERS) == 0) {
+                ringReady = true;
+            } else {
+                io_uring_queue_exit(&ring);
+            }
+        }
+#endif
+        return true;
+    }
+
+    bool isOpen() const { return fd >= 0; }
+
+    const char* backendName() const {
+#ifdef AMS_WITH_IO_URING
+        if (ringReady) return "io_uring";
+#endif
+        return "pwrite";
+    }
+
+    void append(const std::string& record) {
+        if (fd < 0) return;
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        if (used + record.size() > BUFFER_SIZE) submitCurrent();
+        if (record.size() > BUFFER_SIZE) {
+            writeAll(record.data(), record.size());
+        } else {
+            std::copy(record.begin(), record.end(), buffer(current) + used);
+            used += record.size();
+        }
+        ++records;
+    }
+
+    // Flush pending records, wait for outstanding writes and sync the file
+    void close() {
+        if (fd < 0) return;
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        submitCurrent();
+#ifdef AMS_WITH_IO_URING
+        if (ringReady) {
+            for (int i = 0; i < NUM_BUFFERS; ++i) reap(i);
+            io_uring_queue_exit(&ring);
+            ringReady = false;
+        }
+#endif
+        ::fsync(fd);
+        ++syscalls;
+        ::close(fd);
+        fd = -1;
+    }
+
+private:
+    int fd = -1;
+    off_t offset = 0;
+    std::vector<char> storage;
+    int current = 0;
+    size_t used = 0;
+    std::mutex sinkMutex;
+
+#ifdef AMS_WITH_IO_URING
+    io_uring ring;
+    bool ringReady = false;
+    size_t inFlight[NUM_BUFFERS] = {}; // bytes submitted from each buffer, 0 if idle
+    off_t inFlightOffset[NUM_BUFFERS] = {};
+
+    // Wait for the write from buffer i; finish any short write synchronously
+    void reap(int i) {
+        while (inFlight[i] > 0) {
+            io_uring_cqe* cqe = nullptr;
+            int waited;
+            while ((waited = io_uring_wait_cqe(&ring, &cqe)) == -EINTR) {
+            }
+            if (waited != 0) return;
+            ++syscalls;
+            int done = static_cast<int>(cqe->user_data);
+            int result = cqe->res;
+            io_uring_cqe_seen(&ring, cqe);
+            size_t written = result > 0 ? static_cast<size_t>(result) : 0;
+            if (written < inFlight[done]) {
+                pwriteAll(buffer(done) + written, inFlight[done] - written, inFlightOffset[done] + written);
+            }
+            inFlight[done] = 0;
+        }
+    }
+#endif
+
+    char* buffer(int i) { return storage.data() + i * BUFFER_SIZE; }
+
+    void submitCurrent() {
+        if (used == 0) return;
+#ifdef AMS_WITH_IO_URING
+        if (ringReady) {
+            io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+            if (sqe) {
+                io_uring_prep_write_fixed(sqe, fd, buffer(current), used, offset, current);
+                sqe->user_data = current;
+                ++syscalls;
+                if (io_uring_submit(&ring) < 1) {
+                    // Nothing will complete for this buffer: let the other writes finish,
+                    // drop the ring (and the unsubmitted entry with it) and write it here
+                    for (int i = 0; i < NUM_BUFFERS; ++i) reap(i);
+                    io_uring_queue_exit(&ring);
+                    ringReady = false;
+                    writeAll(buffer(current), used);
+                    used = 0;
+                    return;
+                }
+                inFlight[current] = used;
+                inFlightOffset[current] = offset;
+                offset += used;
+                used = 0;
+                // Double buffering: only wait if the next buffer is still being written
+                current = (current + 1) % NUM_BUFFERS;
+                reap(current);
+                return;
+            }
+        }
+#endif
+        writeAll(buffer(current), used);
+        used = 0;
+    }
+
+    void writeAll(const char* data, size_t size) {
+        pwriteAll(data, size, offset);
+        offset += size;
+    }
+
+    void pwriteAll(const char* data, size_t size, off_t at) {
+        while (size > 0) {
+            ssize_t n = ::pwrite(fd, data, size, at);
+            ++syscalls;
+            if (n <= 0) return;
+            data += n;
+            size -= n;
+            at += n;
+        }
+    }
+};
+
+EventSink journal; // intake, assign and release events
+EventSink results; // one line per completed flight
+
+enum class EventType : int32_t { Intake = 0, Assign = 1, Release = 2 };
+
+const char* eventName(EventType type) {
+    switch (type) {
+        case EventType::Intake: return "intake";
+        case EventType::Assign: return "assign";
+        case EventType::Release: return "release";
+    }
+    return "unknown";
+}
+
+// Scheduling event stream in a memory-mapped file ring that other processes can tail.
+// Writes are serialized, so the ring has a single writer; any number of readers map the
+// file read-only and never slow the writer down. Each slot carries its own sequence
+// word (odd while being written, 2n+2 once event n is complete), so a reader that is
+// lapped by the writer notices the torn or overwritten slot and skips ahead.
+class EventRingLog {
+public:
+    static constexpr uint64_t MAGIC = 0x414d5352494e4731ULL; // "AMSRING1"
+
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        int64_t timeMs;
+        int32_t type;
+        int32_t flightId;
+        int32_t runwayId;
+        int32_t reserved;
+    };
+
+    struct Header {
+        uint64_t magic;
+        uint64_t capacity;             // number of slots, a power of two
+        std::atomic<uint64_t> written; // events published so far
+        char padding[64 - 3 * sizeof(uint64_t)];
+    };
+
+    EventRingLog() = default;
+    EventRingLog(const EventRingLog&) = delete;
+    EventRingLog& operator=(const EventRingLog&) = delete;
+
+    ~EventRingLog() { unmap(); }
+
+    static size_t mappedSize(uint64_t capacity) {
+        return sizeof(Header) + capacity * sizeof(Slot);
+    }
+
+    // Creates (or truncates) the ring file for writing
+    bool create(const std::string& path, uint64_t capacity) {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        size_t size = mappedSize(capacity);
+        bool ok = ::ftruncate(fd, size) == 0 && map(fd, size, PROT_READ | PROT_WRITE);
+        ::close(fd);
+        if (!ok) return false;
+        // A freshly truncated file is zero-filled: every slot starts with seq 0 ("empty")
+        header->capacity = capacity;
+        header->written.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = MAGIC;
+        return true;
+    }
+
+    // Maps an existing ring file read-only for tailing
+    bool attach(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        bool ok = ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header) &&
+                  map(fd, st.st_size, PROT_READ);
+        ::close(fd);
+        if (!ok || header->magic != MAGIC || mappedSize(header->capacity) > mappedBytes) {
+            unmap();
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+
+    void append(EventType type, int flightId, int runwayId, long long timeMs) {
+        if (!header) return;
+        std::lock_guard<std::mutex> lock(writerMutex);
+        uint64_t n = header->written.load(std::memory_order_relaxed);
+        Slot& slot = slots[n & (header->capacity - 1)];
+        slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.timeMs = timeMs;
+        slot.type = static_cast<int32_t>(type);
+        slot.flightId = flightId;
+        slot.runwayId = runwayId;
+        slot.seq.store(2 * n + 2, std::memory_order_release);
+        header->written.store(n + 1, std::memory_order_release);
+    }
+
+    // Reads event number `cursor` into `event`. Returns false if it is not written yet.
+    // If the writer has lapped the reader, `cursor` is moved to the oldest event still
+    // in the ring and the number of lost events is added to `lost`.
+    bool read(uint64_t& cursor, Slot& event, uint64_t& lost) const {
+        while (true) {
+            uint64_t written = header->written.load(std::memory_order_acquire);
+            if (cursor >= written) return false;
+            if (written - cursor > header->capacity) {
+                lost += written - header->capacity - cursor;
+                cursor = written - header->capacity;
+            }
+            const Slot& slot = slots[cursor & (header->capacity - 1)];
+            uint64_t before = slot.seq.load(std::memory_order_acquire);
+            event.timeMs = slot.timeMs;
+            event.type = slot.type;
+            event.flightId = slot.flightId;
+            event.runwayId = slot.runwayId;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = slot.seq.load(std::memory_order_relaxed);
+            if (before == 2 * cursor + 2 && after == before) return true;
+            // Overwritten while we were reading; resynchronize on the next pass
+            lost += 1;
+            cursor += 1;
+        }
+    }
+
+private:
+    Header* header = nullptr;
+    Slot* slots = nullptr;
+    size_t mappedBytes = 0;
+    std::mutex writerMutex;
+
+    bool map(int fd, size_t size, int protection) {
+        void* addr = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) return false;
+        header = static_cast<Header*>(addr);
+        slots = reinterpret_cast<Slot*>(static_cast<char*>(addr) + sizeof(Header));
+        mappedBytes = size;
+        return true;
+    }
+
+    void unmap() {
+        if (header) ::munmap(header, mappedBytes);
+        header = nullptr;
+        slots = nullptr;
+        mappedBytes = 0;
+    }
+};
+
+EventRingLog eventRing;
+
+// Records a scheduling event in every enabled event sink
+void recordEvent(EventType type, const Flight& flight, int runwayId) {
+    PhaseScope phase(Phase::Logging);
+    long long timeMs = nowMs();
+    eventRing.append(type, flight.id, runwayId, timeMs);
+    if (!journal.isOpen()) return;
+    journal.append(std::to_string(timeMs) + " " + eventName(type) + " " + std::to_string(flight.id) +
+                   " " + std::to_string(runwayId) + "\n");
+}
+
+// Tailer mode: follows a ring written by another scheduler process and prints each event
+int tailEventRing(const std::string& path) {
+    EventRingLog ring;
+    if (!ring.attach(path)) {
+        std::cout << "Could not attach to event ring " << path << "." << std::endl;
+        return 1;
+    }
+    uint64_t cursor = 0, lost = 0, reportedLost = 0;
+    EventRingLog::Slot event;
+    while (true) {
+        if (!ring.read(cursor, event, lost)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        if (lost != reportedLost) {
+            std::cout << "(skipped " << lost - reportedLost << " overwritten events)" << std::endl;
+            reportedLost = lost;
+        }
+        std::cout << event.timeMs << " " << eventName(static_cast<EventType>(event.type)) << " "
+                  << event.flightId << " " << event.runwayId << std::endl;
+        ++cursor;
+    }
+}
+
+// A period of reduced runway capacity: during [startMinute, endMinute) movements on the
+// runway (0 for every runway) take `factor` times as long, covering both the longer
+// occupancy and the wider separation of low visibility or strong wind
+struct WeatherEvent {
+    int startMinute;
+    int endMinute;
+    int runwayId;
+    double factor;
+};
+
+// Full-day weather scenario, loaded before the scheduler starts and read-only afterwards
+class WeatherScenario {
+public:
+    std::vector<WeatherEvent> events; // sorted by start time
+
+    // Reads "<HH:MM> <HH:MM> <runway id or *> <factor>" lines
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) return false;
+        events.clear();
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream in(line);
+            std::string start, end, runway;
+            WeatherEvent event;
+            if (!(in >> start) || start[0] == '#') continue;
+            if (!(in >> end >> runway >> event.factor) || event.factor < 1.0) return false;
+            event.startMinute = minuteOfDay(start);
+            event.endMinute = minuteOfDay(end);
+            event.runwayId = 0;
+            if (runway != "*") {
+                // A runway id is a positive number and nothing else
+                std::istringstream id(runway);
+                char extra;
+                if (!(id >> event.runwayId) || event.runwayId < 1 || (id >> extra)) return false;
+            }
+            if (event.startMinute < 0 || event.endMinute <= event.startMinute) return false;
+            events.push_back(event);
+        }
+        std::sort(events.begin(), events.end(),
+                  [](const WeatherEvent& a, const WeatherEvent& b) { return a.startMinute < b.startMinute; });
+        return true;
+    }
+
+    // Largest factor in force on the runway at the given minute; 1 in clear weather
+    double factorAt(int runwayId, int minute) const {
+        double factor = 1.0;
+        for (const auto& event : events) {
+            if (event.startMinute > minute) break;
+            if (minute < event.endMinute && (event.runwayId == 0 || event.runwayId == runwayId)) {
+                factor = std::max(factor, event.factor);
+            }
+        }
+        return factor;
+    }
+};
+
+WeatherScenario weather;
+
+// Samples runway occupancy times; only used by the dispatcher under runwayMutex, so
+// a run is reproducible for a given --seed and dispatch order
+Xoshiro256 occupancyRng;
+
+// Extra taxi time for every other flight already using the taxi route of a runway
+constexpr int TAXI_CONFLICT_PENALTY_SECONDS = 30;
+
+// Taxi time between the flight's gate and runway slot `slot`, plus a hold for each
+// movement already on that runway's taxi route; -1 if unknown. O(1): one matrix
+// lookup and one atomic load.
+int estimateTaxiSeconds(const LiveConfig& config, const Flight& flight, size_t slot) {
+    if (flight.gate < 1 || flight.gate > config.gateCount) return -1;
+    // Arrivals taxi from their precomputed exit when the runway has an exit model
+    const ExitChoice& exit = config.exitFor(slot, flight);
+    bool viaExit = flight.type == "arrival" && exit.occupancyPercent > 0;
+    uint16_t seconds = viaExit ? exit.taxiSeconds : config.taxiSeconds[(flight.gate - 1) * runways.size() + slot];
+    if (seconds == UNREACHABLE_TAXI) return -1;
+    return seconds * 100 / profileOf(flight.category).taxiSpeedPercent + runways[slot].taxiMovements.load(std::memory_order_relaxed) * TAXI_CONFLICT_PENALTY_SECONDS;
+}
+
+// Marks runway slot `slot` occupied by `flight` and books how long it will hold it.
+// `taxiing` counts the flight on the runway's taxi route. Caller holds runwayMutex.
+Runway* occupyRunway(const LiveConfig& config, size_t slot, const Flight& flight, bool taxiing) {
+    Runway& runway = runways[slot];
+    runway.isAvailable = false;
+    if (taxiing) runway.taxiMovements.fetch_add(1, std::memory_order_relaxed);
+    long long since = nowMs();
+    // Scale by aircraft category, leave wake separation behind the previous movement,
+    // then let the weather at the flight's scheduled time stretch the result
+    // A landing holds the runway until its precomputed exit, which already reflects the
+    // category's landing roll
+    int32_t occupancy = config.occupancyModels[slot].sample(occupancyRng);
+    const ExitChoice& exit = config.exitFor(slot, flight);
+    int occupancyPercent = flight.type == "arrival" && exit.occupancyPercent > 0
+                               ? exit.occupancyPercent : profileOf(flight.category).occupancyPercent;
+    // Only the part of the separation that has not already elapsed since the previous
+    // movement cleared is still owed
+    long long idleMs = std::max(0LL, since - runway.lastFreeMs);
+    long long separation = std::max(0LL, wakeSeparationMs(runway.lastCategory, flight.category) - idleMs);
+    occupancy = occupancy * occupancyPercent / 100 + static_cast<int32_t>(separation);
+    runway.lastCategory = flight.category;
+    occupancy = static_cast<int32_t>(occupancy * weather.factorAt(runway.id, minuteOfDay(flight.time)));
+    runway.publishOccupancy(flight.id, since, since + occupancy);
+    runway.lastFreeMs = since + occupancy;
+    return &runway;
+}
+
+// Picks a free open runway and marks it occupied. Flights with a known gate get the
+// runway with the shortest estimated taxi time; otherwise the first free runway wins.
+// `taxiing` is set when the flight was counted on the runway's taxi route.
+// Caller holds runwayMutex.
+Runway* claimRunway(const Flight& flight, bool& taxiing) {
+    auto guard = configEpochs.pin();
+    const LiveConfig* config = liveConfig.load(std::memory_order_acquire);
+    size_t best = runways.size();
+    int bestTaxi = INT32_MAX;
+
+    // A runway from the slot plan wins whenever it is free
+    size_t planned = static_cast<size_t>(flight.plannedRunway - 1);
+    if (flight.plannedRunway > 0 && planned < runways.size() && runways[planned].isAvailable &&
+        config->occupancyMs[planned] > 0) {
+        best = planned;
+        bestTaxi = estimateTaxiSeconds(*config, flight, planned);
+        if (bestTaxi < 0) bestTaxi = INT32_MAX;
+    }
+
+    if (best == runways.size()) {
+        for (size_t i = 0; i < runways.size(); ++i) {
+            if (!runways[i].isAvailable || config->occupancyMs[i] <= 0) continue;
+            int taxi = estimateTaxiSeconds(*config, flight, i);
+            if (taxi < 0) {
+                if (best == runways.size()) best = i;
+                continue;
+            }
+            if (taxi < bestTaxi) {
+                best = i;
+                bestTaxi = taxi;
+            }
+        }
+    }
+    if (best == runways.size()) return nullptr;
+    taxiing = bestTaxi != INT32_MAX;
+    return occupyRunway(*config, best, flight, taxiing);
+}
+
+void assignLanding(Flight flight, Runway* runway, bool taxiing) {
+    if (currentRole.load(std::memory_order_relaxed) == static_cast<uint8_t>(ThreadRole::Other)) {
+        setThreadRole(ThreadRole::Landing);
+    }
+    PhaseScope landing(Phase::Landing);
+    const char* operation = flight.type == "departure" ? "Takeoff" : "Landing";
+    std::cout << operation << " Flight ID: " << flight.id << " assigned to runway " << runway->id << "." << std::endl;
+    flightStatus.transition(flight.handle, FlightState::Assigned, FlightState::OnRunway);
+
+    // Simulate landing time, as booked when the runway was claimed
+    RunwayOccupancy booking = runway->readOccupancy();
+    std::this_thread::sleep_for(std::chrono::milliseconds(booking.expectedFreeMs - booking.sinceMs));
+
+    // Mark runway as available
+    long long assignedMs = booking.sinceMs;
+    PhaseScope release(Phase::Release);
+    {
+        std::lock_guard<std::mutex> lock(runwayMutex);
+        runway->isAvailable = true;
+        runway->clearOccupancy();
+        flightStatus.transition(flight.handle, FlightState::OnRunway, FlightState::Completed);
+        flightStore.release(flight.handle);
+        completion.completed();
+    }
+    if (taxiing) runway->taxiMovements.fetch_sub(1, std::memory_order_relaxed);
+    recordEvent(EventType::Release, flight, runway->id);
+    if (results.isOpen()) {
+        PhaseScope logging(Phase::Logging);
+        results.append(std::to_string(flight.id) + "," + std::to_string(runway->id) + "," +
+                       std::to_string(assignedMs) + "," + std::to_string(nowMs()) + "\n");
+    }
+    std::cout << "Runway " << runway->id << " is now available." << std::endl;
+
+    // Notify checkWaitingFlights about the availability
+    runwayAvailableCV.notify_one();
+}
+
+// Runway-affine dispatch (--dispatch affine). Each runway slot has its own queue and a
+// worker thread that serves that runway. Intake files a flight under the runway it
+// prefers: its slot-plan runway, else the shortest estimated taxi from its gate, else
+// the shortest queue. So in the common case a flight is queued and dispatched under
+// that one runway's lock. A worker whose own queue is empty steals from the tail of
+// the longest other queue, which also drains runways closed by a reload. Idle workers
+// sleep until intake, a backlog elsewhere, a reload or shutdown wakes them; the worker of
+// a closed runway only hands its queue to the open ones. Preempted flights queue ahead of
+// regular ones on every runway. Booking and releasing the
+// runway still take runwayMutex briefly, as the occupancy sampler is shared; airline
+// fair sharing, the optimizer and shedding apply only to the central dispatcher.
+class AffineDispatcher {
+public:
+    bool enabled() const { return active.load(std::memory_order_acquire); }
+
+    // One worker per runway slot; call before any flight is submitted
+    void start() {
+        count = runways.size();
+        queues.reset(new RunwayQueue[count]);
+        active.store(true, std::memory_order_release);
+        for (size_t slot = 0; slot < count; ++slot) workers.emplace_back(&AffineDispatcher::serve, this, slot);
+    }
+
+    // Queues an admitted flight under its preferred runway
+    void submit(const Flight& flight, PriorityClass cls) {
+        size_t slot = preferredSlot(flight);
+        RunwayQueue& queue = queues[slot];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            link(queue, cls, flight.handle);
+        }
+        queue.cv.notify_one();
+        // A backlog is building on this runway, or it closed under us: send an idle one over to steal
+        if (queue.depth.load() > 1 || !isOpen(slot)) wakeIdle(slot, 1);
+    }
+
+    // After a reload has opened or closed runways, every worker looks at its queue again
+    void configChanged() {
+        if (!enabled()) return;
+        for (size_t slot = 0; slot < count; ++slot) {
+            {
+                std::lock_guard<std::mutex> lock(queues[slot].mutex);
+                queues[slot].wake = true;
+            }
+            queues[slot].cv.notify_one();
+        }
+    }
+
+    // Drops every queued flight at the drain deadline; returns how many
+    int cancelQueued() {
+        std::vector<int> handles;
+        for (size_t slot = 0; slot < count; ++slot) {
+            RunwayQueue& queue = queues[slot];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            for (int cls = 0; cls < NUM_PRIORITY_CLASSES; ++cls) {
+                int handle;
+                while ((handle = unlinkFront(queue, cls)) >= 0) {
+                    std::cout << "Flight ID: " << flightStore.record(handle).flight.id
+                              << " cancelled: drain deadline passed." << std::endl;
+                    flightStatus.transition(handle, FlightState::Queued, FlightState::Cancelled);
+                    admission.release(static_cast<PriorityClass>(cls));
+                    completion.completed();
+                    handles.push_back(handle);
+                }
+            }
+        }
+        for (int handle : handles) flightStore.release(handle);
+        return static_cast<int>(handles.size());
+    }
+
+    // Once every accepted flight is done
+    void stop() {
+        stopping.store(true, std::memory_order_release);
+        for (size_t slot = 0; slot < count; ++slot) {
+            std::lock_guard<std::mutex> lock(queues[slot].mutex);
+            queues[slot].cv.notify_all();
+        }
+        for (auto& worker : workers) worker.join();
+        workers.clear();
+    }
+
+    void printReport() const {
+        if (!enabled()) return;
+        std::cout << "Affine dispatch: " << localDispatches.load() << " flights from their own runway queue, "
+                  << steals.load() << " stolen" << std::endl;
+    }
+
+private:
+    struct alignas(64) RunwayQueue {
+        std::mutex mutex;
+        std::condition_variable cv;
+        int head[NUM_PRIORITY_CLASSES] = {-1, -1}; // intrusive lists through the flight store
+        int tail[NUM_PRIORITY_CLASSES] = {-1, -1};
+        std::atomic<int> depth{0};
+        std::atomic<bool> idle{false};
+        bool wake = false; // set under `mutex` to send the idle worker looking for work
+    };
+
+    std::unique_ptr<RunwayQueue[]> queues;
+    size_t count = 0;
+    std::vector<std::thread> workers;
+    std::atomic<bool> active{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<long long> localDispatches{0};
+    std::atomic<long long> steals{0};
+
+    static bool isOpen(size_t slot) {
+        auto guard = configEpochs.pin();
+        return liveConfig.load(std::memory_order_acquire)->occupancyMs[slot] > 0;
+    }
+
+    size_t preferredSlot(const Flight& flight) const {
+        auto guard = configEpochs.pin();
+        const LiveConfig* config = liveConfig.load(std::memory_order_acquire);
+        size_t planned = static_cast<size_t>(flight.plannedRunway - 1);
+        if (flight.plannedRunway > 0 && planned < count && config->occupancyMs[planned] > 0) return planned;
+
+        size_t best = count;
+        int bestTaxi = INT32_MAX;
+        int bestDepth = INT32_MAX;
+        for (size_t slot = 0; slot < count; ++slot) {
+            if (config->occupancyMs[slot] <= 0) continue;
+            int taxi = estimateTaxiSeconds(*config, flight, slot);
+            int depth = queues[slot].depth.load(std::memory_order_relaxed);
+            if (taxi < 0) taxi = INT32_MAX;
+            if (taxi < bestTaxi || (taxi == bestTaxi && depth < bestDepth)) {
+                best = slot;
+                bestTaxi = taxi;
+                bestDepth = depth;
+            }
+        }
+        return best == count ? 0 : best; // every runway closed: wait for the first to reopen
+    }
+
+    // The three list helpers need the queue's mutex
+    static void link(RunwayQueue& queue, PriorityClass cls, int handle) {
+        int c = static_cast<int>(cls);
+        FlightRecord& record = flightStore.record(handle);
+        record.prev = queue.tail[c];
+        record.next = -1;
+        if (queue.tail[c] >= 0) {
+            flightStore.record(queue.tail[c]).next = handle;
+        } else {
+            queue.head[c] = handle;
+        }
+        queue.tail[c] = handle;
+        queue.depth.fetch_add(1); // ordered against wakeIdle()'s read of `idle`
+    }
+
+    static int unlinkFront(RunwayQueue& queue, int c) {
+        int handle = queue.head[c];
+        if (handle < 0) return -1;
+        FlightRecord& record = flightStore.record(handle);
+        queue.head[c] = record.next;
+        if (record.next >= 0) flightStore.record(record.next).prev = -1; else queue.tail[c] = -1;
+        record.prev = record.next = -1;
+        queue.depth.fetch_sub(1, std::memory_order_relaxed);
+        return handle;
+    }
+
+    static int unlinkBack(RunwayQueue& queue, int c) {
+        int handle = queue.tail[c];
+        if (handle < 0) return -1;
+        FlightRecord& record = flightStore.record(handle);
+        queue.tail[c] = record.prev;
+        if (record.prev >= 0) flightStore.record(record.prev).next = -1; else queue.head[c] = -1;
+        record.prev = record.next = -1;
+        queue.depth.fetch_sub(1, std::memory_order_relaxed);
+        return handle;
+    }
+
+    // Next flight in the queue, preempted first; -1 when empty
+    static int popFront(RunwayQueue& queue, PriorityClass& cls) {
+        for (int c = 0; c < NUM_PRIORITY_CLASSES; ++c) {
+            int handle = unlinkFront(queue, c);
+            if (handle >= 0) {
+                cls = static_cast<PriorityClass>(c);
+                return handle;
+            }
+        }
+        return -1;
+    }
+
+    // The longest other queue worth stealing from, or `count` if there is none
+    size_t victimFor(size_t thief) const {
+        size_t victim = count;
+        int longest = 0;
+        for (size_t slot = 0; slot < count; ++slot) {
+            int depth = queues[slot].depth.load();
+            // A queue with one flight is left to its own runway unless that runway is closed
+            int worth = isOpen(slot) ? depth - 1 : depth;
+            if (slot != thief && worth > longest) {
+                victim = slot;
+                longest = worth;
+            }
+        }
+        return victim;
+    }
+
+    // Takes the tail of the longest other queue, preempted first; -1 if there is none
+    int steal(size_t thief, PriorityClass& cls) {
+        size_t victim = victimFor(thief);
+        if (victim == count) return -1;
+        std::lock_guard<std::mutex> lock(queues[victim].mutex);
+        for (int c = 0; c < NUM_PRIORITY_CLASSES; ++c) {
+            int handle = unlinkBack(queues[victim], c);
+            if (handle >= 0) {
+                cls = static_cast<PriorityClass>(c);
+                return handle;
+            }
+        }
+        return -1;
+    }
+
+    // Sends up to `wanted` idle workers of open runways looking for work
+    void wakeIdle(size_t busy, int wanted) {
+        for (size_t slot = 0; slot < count && wanted > 0; ++slot) {
+            if (slot == busy || !queues[slot].idle.load() || !isOpen(slot)) continue;
+            {
+                std::lock_guard<std::mutex> lock(queues[slot].mutex);
+                if (queues[slot].wake) continue;
+                queues[slot].wake = true;
+            }
+            queues[slot].cv.notify_one();
+            --wanted;
+        }
+    }
+
+    void serve(size_t slot) {
+        setThreadRole(ThreadRole::RunwayWorker);
+        RunwayQueue& own = queues[slot];
+        while (true) {
+            PriorityClass cls = PriorityClass::Regular;
+            int handle = -1;
+            bool open = isOpen(slot);
+            if (open) {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                handle = popFront(own, cls);
+            }
+            if (handle >= 0) {
+                localDispatches.fetch_add(1, std::memory_order_relaxed);
+            } else if (open && (handle = steal(slot, cls)) >= 0) {
+                steals.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (handle >= 0) {
+                land(slot, handle, cls);
+                continue;
+            }
+
+            // A closed runway cannot serve its own queue: hand it to the open ones
+            if (!open && own.depth.load() > 0) wakeIdle(slot, own.depth.load());
+
+            std::unique_lock<std::mutex> lock(own.mutex);
+            // Publish `idle` before looking at the depths, so a submit either sees us idle
+            // and wakes us or its flight is already counted here
+            own.idle.store(true);
+            own.cv.wait(lock, [&] {
+                if (stopping.load(std::memory_order_acquire) || own.wake) return true;
+                return open && (own.depth.load() > 0 || victimFor(slot) != count);
+            });
+            own.idle.store(false);
+            own.wake = false;
+            if (stopping.load(std::memory_order_acquire)) return;
+        }
+    }
+
+    // The worker is the runway: it books it and lands the flight itself
+    void land(size_t slot, int handle, PriorityClass cls) {
+        PhaseScope dispatching(Phase::Dispatch);
+        Flight flight = flightStore.record(handle).flight;
+        admission.release(cls);
+        flightStatus.transition(handle, FlightState::Queued, FlightState::Assigned);
+        Runway* runway;
+        bool taxiing;
+        {
+            std::lock_guard<std::mutex> lock(runwayMutex);
+            auto guard = configEpochs.pin();
+            const LiveConfig* config = liveConfig.load(std::memory_order_acquire);
+            taxiing = estimateTaxiSeconds(*config, flight, slot) >= 0;
+            runway = occupyRunway(*config, slot, flight, taxiing);
+        }
+        recordEvent(EventType::Assign, flight, runway->id);
+        assignLanding(flight, runway, taxiing);
+    }
+};
+
+AffineDispatcher affineDispatcher;
+
+// Intake path: admit the flight into its priority queue (or its runway's queue under
+// affine dispatch) and wake the dispatcher.
+// Returns false if the flight was turned away.
+bool submitFlight(const Flight& flight) {
+    PhaseScope phase(Phase::Intake);
+    PriorityClass cls = priorityClassOf(flight);
+
+    if (schedulerState.load(std::memory_order_acquire) != SchedulerState::Running) {
+        admission.recordRejected(cls);
+        flightStatus.transition(flight.handle, FlightState::Scheduled, FlightState::Cancelled);
+        flightStore.release(flight.handle);
+        std::cout << "Flight ID: " << flight.id << " rejected: scheduler is draining." << std::endl;
+        return false;
+    }
+
+    if (!admission.tryAcquire(cls)) {
+        if (admission.policy == AdmissionPolicy::BlockProducer) {
+            admission.acquireBlocking(cls);
+        } else if (admission.policy == AdmissionPolicy::ShedLowest) {
+            std::lock_guard<std::mutex> lock(runwayMutex);
+            FairQueue& queue = queueFor(cls);
+            const Flight* lowest = queue.lowestPriority();
+            if (!lowest || lowest->priority <= flight.priority) {
+                admission.recordRejected(cls);
+                flightStatus.transition(flight.handle, FlightState::Scheduled, FlightState::Cancelled);
+                flightStore.release(flight.handle);
+                std::cout << "Flight ID: " << flight.id << " shed: queue full." << std::endl;
+                return false;
+            }
+            // Swap places with the queued flight; the queue depth is unchanged
+            std::cout << "Flight ID: " << lowest->id << " shed for higher priority flight " << flight.id << "." << std::endl;
+            int shedHandle = lowest->handle;
+            flightStatus.transition(shedHandle, FlightState::Queued, FlightState::Cancelled);
+            queue.erase(shedHandle);
+            flightStore.release(shedHandle);
+            completion.completed();
+            completion.accepted();
+            flightStatus.transition(flight.handle, FlightState::Scheduled, FlightState::Queued);
+            queue.push_back(flight);
+            admission.recordShed(cls);
+            recordEvent(EventType::Intake, flight, NO_FLIGHT);
+            runwayAvailableCV.notify_one();
+            return true;
+        } else {
+            admission.recordRejected(cls);
+            flightStatus.transition(flight.handle, FlightState::Scheduled, FlightState::Cancelled);
+            flightStore.release(flight.handle);
+            std::cout << "Flight ID: " << flight.id << " rejected: queue full." << std::endl;
+            return false;
+        }
+    }
+
+    if (affineDispatcher.enabled()) {
+        completion.accepted();
+        flightStatus.transition(flight.handle, FlightState::Scheduled, FlightState::Queued);
+        recordEvent(EventType::Intake, flight, NO_FLIGHT);
+        affineDispatcher.submit(flight, cls);
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(runwayMutex);
+        completion.accepted();
+        flightStatus.transition(flight.handle, FlightState::Scheduled, FlightState::Queued);
+        queueFor(cls).push_back(flight);
+    }
+    recordEvent(EventType::Intake, flight, NO_FLIGHT);
+    runwayAvailableCV.notify_one();
+    return true;
+}
+
+bool anyRunwayAvailable() {
+    auto guard = configEpochs.pin();
+    const LiveConfig* config = liveConfig.load(std::memory_order_acquire);
+    for (size_t i = 0; i < runways.size(); ++i) {
+        if (runways[i].isAvailable && config->occupancyMs[i] > 0) return true;
+    }
+    return false;
+}
+
+// Stops intake and lets the monitor finish. With a timeout, flights still queued when
+// it expires are cancelled; landings already on a runway always complete.
+void beginDrain(std::optional<std::chrono::milliseconds> timeout) {
+    {
+        std::lock_guard<std::mutex> lock(runwayMutex);
+        schedulerState = SchedulerState::Draining;
+        if (timeout) drainDeadline = std::chrono::steady_clock::now() + *timeout;
+    }
+    runwayAvailableCV.notify_all();
+}
+
+// Drops every queued flight, central or runway-affine. Caller holds runwayMutex.
+int cancelQueuedFlights() {
+    std::vector<int> handles;
+    for (PriorityClass cls : {PriorityClass::Preempted, PriorityClass::Regular}) {
+        FairQueue& queue = queueFor(cls);
+        queue.forEach([cls, &handles](const Flight& flight) {
+            std::cout << "Flight ID: " << flight.id << " cancelled: drain deadline passed." << std::endl;
+            flightStatus.transition(flight.handle, FlightState::Queued, FlightState::Cancelled);
+            admission.release(cls);
+            completion.completed();
+            handles.push_back(flight.handle);
+        });
+        queue.clear();
+    }
+    for (int handle : handles) flightStore.release(handle);
+    return static_cast<int>(handles.size()) + affineDispatcher.cancelQueued();
+}
+
+// Sequence recommended by the rolling horizon optimizer. Immutable once published.
+struct RecommendedSequence {
+    std::vector<int> handles;
+};
+
+std::atomic<const RecommendedSequence*> recommendedSequence{nullptr};
+EpochDomain sequenceEpochs;
+std::atomic<bool> optimizerEnabled{false};
+
+// Handle of the first flight in the recommended sequence still waiting in `queue`, or -1.
+// Reads the recommendation without taking any lock.
+int recommendedNext(const FairQueue& queue) {
+    if (!optimizerEnabled.load(std::memory_order_relaxed)) return -1;
+    auto guard = sequenceEpochs.pin();
+    const RecommendedSequence* sequence = recommendedSequence.load(std::memory_order_acquire);
+    if (!sequence) return -1;
+    for (int handle : sequence->handles) {
+        if (queue.contains(handle)) return handle;
+    }
+    return -1;
+}
+
+// Appends up to `limit` handles of the recommended sequence that are still waiting in
+// either queue, in recommended order. Caller holds runwayMutex.
+void recommendedWaiting(size_t limit, std::vector<int>& out) {
+    if (!optimizerEnabled.load(std::memory_order_relaxed)) return;
+    auto guard = sequenceEpochs.pin();
+    const RecommendedSequence* sequence = recommendedSequence.load(std::memory_order_acquire);
+    if (!sequence) return;
+    for (int handle : sequence->handles) {
+        if (out.size() >= limit) break;
+        if (preemptedFlights.contains(handle) || regularFlights.contains(handle)) out.push_back(handle);
+    }
+}
+
+// Background optimizer: repeatedly takes the next waiting flights in dispatch order and
+// replays them on the open runways in the dispatcher's own clock, each flight taking the
+// runway that frees first and holding it for its category's share of the runway's
+// occupancy plus any wake separation still due behind the previous movement. Pairwise
+// swaps within a priority class then minimise the priority-weighted queueing delay
+// (start minus queuedMs), mostly by grouping categories so that less separation is
+// paid; the result is published for the dispatcher.
+class RollingHorizonOptimizer {
+public:
+    static constexpr size_t MAX_WINDOW_FLIGHTS = 48;
+    static constexpr int MAX_PASSES = 16;
+
+    void run(std::chrono::milliseconds period) {
+        setThreadRole(ThreadRole::Optimizer);
+        std::unique_lock<std::mutex> lock(stopMutex);
+        while (!stopCV.wait_for(lock, period, [this] { return stopping; })) {
+            lock.unlock();
+            solveOnce();
+            lock.lock();
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(stopMutex);
+            stopping = true;
+        }
+        stopCV.notify_all();
+    }
+
+    // The measured queueing delay, printed at exit, is what to compare against a run
+    // without the optimizer; this is only what the model expected
+    void printReport() const {
+        std::cout << "Optimizer: " << solves << " solves, " << reordered << " reordered; modelled weighted delay "
+                  << dispatchOrderCost / 1000.0 << " s -> " << optimizedCost / 1000.0 << " s" << std::endl;
+    }
+
+private:
+    struct Candidate {
+        int handle;
+        long long queuedMs;
+        double weight;
+        AircraftCategory category;
+        bool preempted;
+    };
+
+    struct RunwayState {
+        long long freeAtMs;
+        long long occupancyMs;
+        AircraftCategory lastCategory;
+    };
+
+    std::vector<RunwayState> runwayStates; // open runways at the current solve
+    std::vector<RunwayState> scratch;
+    long long now = 0;
+    long long solves = 0;
+    long long reordered = 0;
+    double dispatchOrderCost = 0;
+    double optimizedCost = 0;
+    bool stopping = false;
+    std::mutex stopMutex;
+    std::condition_variable stopCV;
+
+    // Priority 1 is the most urgent and weighs the most
+    static double weightOf(int priority) { return 1.0 / std::max(priority, 1); }
+
+    // Weighted queueing delay if the flights take runways in this order from `now`
+    double cost(const std::vector<Candidate>& order) {
+        scratch = runwayStates;
+        double total = 0;
+        for (const auto& candidate : order) {
+            RunwayState* runway = &scratch[0];
+            for (auto& state : scratch) {
+                if (state.freeAtMs < runway->freeAtMs) runway = &state;
+            }
+            long long start = std::max(runway->freeAtMs, now);
+            long long separation = wakeSeparationMs(runway->lastCategory, candidate.category);
+            separation = std::max(0LL, separation - (start - runway->freeAtMs));
+            runway->freeAtMs = start + runway->occupancyMs * profileOf(candidate.category).occupancyPercent / 100 +
+                               separation;
+            runway->lastCategory = candidate.category;
+            total += candidate.weight * (start - candidate.queuedMs);
+        }
+        return total;
+    }
+
+    void solveOnce() {
+        PhaseScope phase(Phase::Optimize);
+        // Snapshot under the dispatcher lock; everything else happens off it
+        std::vector<Candidate> window;
+        {
+            std::lock_guard<std::mutex> lock(runwayMutex);
+            std::vector<int> handles;
+            preemptedFlights.peekInOrder(MAX_WINDOW_FLIGHTS, handles);
+            size_t preempted = handles.size();
+            regularFlights.peekInOrder(MAX_WINDOW_FLIGHTS - preempted, handles);
+            for (size_t i = 0; i < handles.size(); ++i) {
+                const FlightRecord& record = flightStore.record(handles[i]);
+                window.push_back({handles[i], record.queuedMs, weightOf(record.flight.priority),
+                                  record.flight.category, i < preempted});
+            }
+
+            auto guard = configEpochs.pin();
+            const LiveConfig* config = liveConfig.load(std::memory_order_acquire);
+            now = nowMs();
+            runwayStates.clear();
+            for (size_t i = 0; i < runways.size(); ++i) {
+                if (config->occupancyMs[i] <= 0) continue;
+                // When the previous movement clears (or cleared), which also dates its wake
+                long long freeAt = runways[i].isAvailable ? std::min(runways[i].lastFreeMs, now) : runways[i].lastFreeMs;
+                runwayStates.push_back({freeAt, config->occupancyMs[i], runways[i].lastCategory});
+            }
+        }
+        if (window.size() < 2 || runwayStates.empty()) return;
+
+        double baseline = cost(window);
+        double best = baseline;
+        // Local search: keep applying the best improving swap of two flights of one class
+        for (int pass = 0; pass < MAX_PASSES; ++pass) {
+            size_t bestI = 0, bestJ = 0;
+            for (size_t i = 0; i < window.size(); ++i) {
+                for (size_t j = i + 1; j < window.size() && window[j].preempted == window[i].preempted; ++j) {
+                    std::swap(window[i], window[j]);
+                    double candidate = cost(window);
+                    std::swap(window[i], window[j]);
+                    if (candidate < best) {
+                        best = candidate;
+                        bestI = i;
+                        bestJ = j;
+                    }
+                }
+            }
+            if (bestI == bestJ) break;
+            std::swap(window[bestI], window[bestJ]);
+        }
+
+        auto* sequence = new RecommendedSequence;
+        for (const auto& candidate : window) sequence->handles.push_back(candidate.handle);
+        const RecommendedSequence* previous = recommendedSequence.exchange(sequence, std::memory_order_acq_rel);
+        if (previous) sequenceEpochs.retire([previous] { delete previous; });
+
+        ++solves;
+        if (best < baseline) ++reordered;
+        dispatchOrderCost += baseline;
+        optimizedCost += best;
+    }
+};
+
+// Matches the next waiting flights to every free runway at once whenever more than one
+// runway is free. Pairing flight i with runway j costs its estimated taxi time minus
+// the flight's urgency: the priority-weighted delay it has accrued plus the runway hold
+// it would wait through if left for the next cycle, on top of a base that makes any
+// flight better than an idle runway (and a larger one for preempted flights). The
+// Hungarian method then finds the exact minimum-cost assignment in O(n^3) for
+// n = max(flights, runways) <= MAX_SIZE; all state is fixed-size, so a cycle does not
+// allocate. Guarded by runwayMutex.
+class RunwayMatcher {
+public:
+    static constexpr int MAX_SIZE = 32;
+
+    struct Match {
+        int handle;
+        PriorityClass cls;
+        size_t slot;
+        bool taxiing;
+    };
+
+    RunwayMatcher() {
+        candidates.reserve(MAX_SIZE);
+    }
+
+    // Fills `matches` and returns how many there are; 0 when fewer than two runways or
+    // two flights are waiting, in which case the caller dispatches one flight as before
+    int match(const LiveConfig& config, Match* matches) {
+        int runwayCount = 0;
+        long long holdMs = 0;
+        for (size_t i = 0; i < runways.size() && runwayCount < MAX_SIZE; ++i) {
+            if (!runways[i].isAvailable || config.occupancyMs[i] <= 0) continue;
+            slots[runwayCount++] = i;
+            holdMs += config.occupancyMs[i];
+        }
+        if (runwayCount < 2 || preemptedFlights.size() + regularFlights.size() < 2) return 0;
+        holdMs /= runwayCount;
+        PhaseScope phase(Phase::Matching);
+
+        auto start = std::chrono::steady_clock::now();
+        candidates.clear();
+        // Following the optimizer, it picks which flights go next and the matching only
+        // places them; otherwise every flight near the head competes on urgency
+        recommendedWaiting(runwayCount, candidates);
+        if (candidates.empty()) {
+            preemptedFlights.peekInOrder(MAX_SIZE, candidates);
+            regularFlights.peekInOrder(MAX_SIZE - candidates.size(), candidates);
+        }
+        int flightCount = static_cast<int>(candidates.size());
+        if (flightCount < 2) return 0;
+        for (int i = 0; i < flightCount; ++i) {
+            classes[i] = preemptedFlights.contains(candidates[i]) ? PriorityClass::Preempted : PriorityClass::Regular;
+        }
+
+        long long now = nowMs();
+        int n = std::max(flightCount, runwayCount);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) cost[i][j] = 0; // padding rows and columns
+        }
+        for (int i = 0; i < flightCount; ++i) {
+            const FlightRecord& record = flightStore.record(candidates[i]);
+            const Flight& flight = record.flight;
+            long long urgency = BASE_URGENCY + (classes[i] == PriorityClass::Preempted ? PREEMPTED_URGENCY : 0) +
+                                (now - record.queuedMs + holdMs) / std::max(flight.priority, 1);
+            for (int j = 0; j < runwayCount; ++j) {
+                int taxi = estimateTaxiSeconds(config, flight, slots[j]);
+                long long taxiMs = taxi < 0 ? UNKNOWN_TAXI_MS : taxi * 1000LL;
+                if (flight.plannedRunway > 0 && runways[slots[j]].id != flight.plannedRunway) {
+                    taxiMs += OFF_PLAN_MS;
+                }
+                cost[i][j] = taxiMs - urgency + i; // queue order breaks ties
+            }
+        }
+        solve(n);
+
+        int count = 0;
+        for (int i = 0; i < flightCount; ++i) {
+            int j = assigned[i];
+            if (j >= runwayCount) continue;
+            int taxi = estimateTaxiSeconds(config, flightStore.record(candidates[i]).flight, slots[j]);
+            matches[count++] = {candidates[i], classes[i], slots[j], taxi >= 0};
+        }
+        ++cycles;
+        matched += count;
+        solveNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        return count;
+    }
+
+    void printReport() const {
+        if (cycles == 0) return;
+        std::cout << "Runway matching: " << cycles << " cycles, " << matched << " flights, "
+                  << solveNs / 1000.0 / cycles << " us per cycle" << std::endl;
+    }
+
+private:
+    static constexpr long long BASE_URGENCY = 1000000000LL;
+    static constexpr long long PREEMPTED_URGENCY = 1000000000000LL;
+    static constexpr long long UNKNOWN_TAXI_MS = 3600 * 1000LL;
+    static constexpr long long OFF_PLAN_MS = 3600 * 1000LL;
+
+    std::vector<int> candidates; // handles, in recommended order or preempted first in dispatch order
+    PriorityClass classes[MAX_SIZE];
+    size_t slots[MAX_SIZE];
+    long long cost[MAX_SIZE][MAX_SIZE];
+    int assigned[MAX_SIZE]; // column matched to each row
+
+    // Hungarian method with row and column potentials (1-based internally)
+    long long u[MAX_SIZE + 1], v[MAX_SIZE + 1], minv[MAX_SIZE + 1];
+    int rowOf[MAX_SIZE + 1], way[MAX_SIZE + 1];
+    bool used[MAX_SIZE + 1];
+
+    long long cycles = 0;
+    long long matched = 0;
+    long long solveNs = 0;
+
+    void solve(int n) {
+        const long long INF = std::numeric_limits<long long>::max() / 4;
+        for (int j = 0; j <= n; ++j) {
+            u[j] = v[j] = 0;
+            rowOf[j] = 0;
+        }
+        for (int i = 1; i <= n; ++i) {
+            rowOf[0] = i;
+            int j0 = 0;
+            for (int j = 0; j <= n; ++j) {
+                minv[j] = INF;
+                used[j] = false;
+            }
+            do {
+                used[j0] = true;
+                int i0 = rowOf[j0], j1 = 0;
+                long long delta = INF;
+                for (int j = 1; j <= n; ++j) {
+                    if (used[j]) continue;
+                    long long reduced = cost[i0 - 1][j - 1] - u[i0] - v[j];
+                    if (reduced < minv[j]) {
+                        minv[j] = reduced;
+                        way[j] = j0;
+                    }
+                    if (minv[j] < delta) {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+                for (int j = 0; j <= n; ++j) {
+                    if (used[j]) {
+                        u[rowOf[j]] += delta;
+                        v[j] -= delta;
+                    } else {
+                        minv[j] -= delta;
+                    }
+                }
+                j0 = j1;
+            } while (rowOf[j0] != 0);
+            do {
+                int j1 = way[j0];
+                rowOf[j0] = rowOf[j1];
+                j0 = j1;
+            } while (j0 != 0);
+        }
+        for (int j = 1; j <= n; ++j) assigned[rowOf[j] - 1] = j - 1;
+    }
+};
+
+RunwayMatcher runwayMatcher;
+
+void checkWaitingFlights() {
+    setThreadRole(ThreadRole::Monitor);
+    std::unordered_map<uint64_t, std::thread> landingThreads;
+    uint64_t nextLanding = 0;
+
+    // Landings that have returned and only need joining. A landing thread adds its
+    // id as its last action, so it never needs runwayMutex after the monitor joins it.
+    std::mutex finishedMutex;
+    std::vector<uint64_t> finished;
+
+    // Joins landings that have finished, keeping landingThreads bounded by the number in flight
+    auto reap = [&] {
+        std::vector<uint64_t> done;
+        {
+            std::lock_guard<std::mutex> guard(finishedMutex);
+            done.swap(finished);
+        }
+        for (uint64_t id : done) {
+            auto it = landingThreads.find(id);
+            it->second.join();
+            landingThreads.erase(it);
+        }
+    };
+
+    // Hands a queued flight that already holds `runway` to its landing thread.
+    // Caller holds runwayMutex.
+    auto dispatch = [&](PriorityClass cls, int handle, Runway* runway, bool taxiing) {
+        FairQueue& queue = queueFor(cls);
+        bool inOrder = queue.front().handle == handle;
+        Flight flight = inOrder ? queue.front() : queue.take(handle);
+        if (inOrder) queue.pop_front();
+        admission.release(cls);
+        flightStatus.transition(flight.handle, FlightState::Queued, FlightState::Assigned);
+
+        recordEvent(EventType::Assign, flight, runway->id);
+        uint64_t id = nextLanding++;
+        landingThreads.emplace(id, std::thread([&finishedMutex, &finished, id, flight, runway, taxiing] {
+            assignLanding(flight, runway, taxiing);
+            std::lock_guard<std::mutex> guard(finishedMutex);
+            finished.push_back(id);
+        }));
+    };
+
+    while (true) {
+        std::unique_lock<std::mutex> lock(runwayMutex);
+
+        // Wait for a queued flight and a free runway, or for the drain to complete
+        auto ready = [] {
+            bool queued = !preemptedFlights.empty() || !regularFlights.empty();
+            if (queued) return anyRunwayAvailable();
+            return schedulerState.load() != SchedulerState::Running && completion.allDone();
+        };
+        if (drainDeadline) {
+            if (!runwayAvailableCV.wait_until(lock, *drainDeadline, ready)) {
+                flightsCancelled += cancelQueuedFlights();
+                drainDeadline.reset();
+                continue;
+            }
+        } else {
+            runwayAvailableCV.wait(lock, ready);
+        }
+        reap();
+
+        // Draining and every accepted flight is finished: we are done
+        if (preemptedFlights.empty() && regularFlights.empty()) break;
+        PhaseScope dispatching(Phase::Dispatch);
+
+        // Preempted flights always go first
+        PriorityClass cls = !preemptedFlights.empty() ? PriorityClass::Preempted : PriorityClass::Regular;
+        FairQueue& queue = queueFor(cls);
+        // With several runways free, place the next flights on all of them together
+        {
+            auto guard = configEpochs.pin();
+            const LiveConfig* config = liveConfig.load(std::memory_order_acquire);
+            RunwayMatcher::Match matches[RunwayMatcher::MAX_SIZE];
+            int count = runwayMatcher.match(*config, matches);
+            for (int m = 0; m < count; ++m) {
+                const RunwayMatcher::Match& match = matches[m];
+                Runway* runway = occupyRunway(*config, match.slot, flightStore.record(match.handle).flight, match.taxiing);
+                dispatch(match.cls, match.handle, runway, match.taxiing);
+            }
+            if (count > 0) continue;
+        }
+
+        bool taxiing = false;
+        int recommended = recommendedNext(queue);
+        int handle = recommended >= 0 ? recommended : queue.front().handle;
+        Runway* runway = claimRunway(queue.find(handle), taxiing);
+        // A reload may have closed the runway we saw free; wait for the next change
+        if (!runway) continue;
+        dispatch(cls, handle, runway, taxiing);
+    }
+
+    for (auto& entry : landingThreads) {
+        entry.second.join();
+    }
+    schedulerState = SchedulerState::Stopped;
+}
+
+// CPUs of a NUMA node, parsed from sysfs ("0-15,32-47"); empty if the node is unknown
+std::vector<int> numaNodeCpus(int node) {
+    std::vector<int> cpus;
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string range;
+    while (std::getline(file, range, ',')) {
+        int first = 0, last = 0;
+        char dash = 0;
+        std::istringstream in(range);
+        if (!(in >> first)) continue;
+        last = (in >> dash >> last) ? last : first;
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// Keeps the scheduler on one NUMA node: pins the calling thread to the node's CPUs and
+// prefers the node for new allocations. Threads started afterwards (monitor, landings)
+// inherit both, and the runway table and flight store are first touched there.
+// Uses the raw syscalls so no libnuma is needed; returns false and leaves placement
+// to the kernel when the node or the syscalls are unavailable.
+bool bindToNumaNode(int node) {
+#ifdef __linux__
+    std::vector<int> cpus = numaNodeCpus(node);
+    if (cpus.empty()) return false;
+
+    const int MPOL_PREFERRED_MODE = 1;
+    unsigned long nodeMask[16] = {};
+    if (node >= static_cast<int>(sizeof(nodeMask) * 8)) return false;
+    nodeMask[node / 64] |= 1UL << (node % 64);
+
+    cpu_set_t original;
+    if (sched_getaffinity(0, sizeof(original), &original) != 0) return false;
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpus) CPU_SET(cpu, &cpuSet);
+    if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) return false;
+
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED_MODE, nodeMask, sizeof(nodeMask) * 8) != 0) {
+        // Half a binding would be reported as default placement: undo the pinning
+        sched_setaffinity(0, sizeof(original), &original);
+        return false;
+    }
+    return true;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+// Hardware performance counters around one scenario (--perf-counters on), read through
+// perf_event_open(2) directly. Counting is inherited by threads started after start(),
+// and an exited thread's counts fold back into the opener, so monitor, landing and
+// runway threads are included once they have been joined. Counts are user-space only
+// and scaled for multiplexing. A counter the kernel refuses (no PMU under a VM,
+// perf_event_paranoid, a seccomp filter) is reported as unavailable and the scenario
+// runs regardless.
+class HardwareCounters {
+public:
+    static constexpr int NUM_COUNTERS = 4;
+
+    HardwareCounters() {
+        for (int& fd : fds) fd = -1;
+    }
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+    ~HardwareCounters() { closeAll(); }
+
+    // Returns false when no counter could be opened
+    bool start() {
+        bool any = false;
+#ifdef __linux__
+        for (int i = 0; i < NUM_COUNTERS; ++i) {
+            perf_event_attr attr = {};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = EVENTS[i].config;
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+            if (fds[i] < 0) {
+                openError = errno;
+                continue;
+            }
+            values[i] = 0;
+            any = true;
+        }
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#else
+        openError = ENOSYS;
+#endif
+        return any;
+    }
+
+    void stop() {
+#ifdef __linux__
+        for (int i = 0; i < NUM_COUNTERS; ++i) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t reading[3] = {}; // value, time enabled, time running
+            if (::read(fds[i], reading, sizeof(reading)) != sizeof(reading) || reading[2] == 0) {
+                values[i] = -1;
+                continue;
+            }
+            values[i] = reading[2] < reading[1]
+                            ? static_cast<long long>(static_cast<double>(reading[0]) * reading[1] / reading[2])
+                            : static_cast<long long>(reading[0]);
+        }
+#endif
+        closeAll();
+    }
+
+    // One line of totals and per-flight deltas for `scenario`
+    void print(const std::string& scenario, long long flights) const {
+        std::cout << "Counters (" << scenario << "):";
+        bool any = false;
+        for (int i = 0; i < NUM_COUNTERS; ++i) {
+            if (values[i] < 0) continue;
+            std::cout << (any ? ", " : " ") << EVENTS[i].name << " " << values[i];
+            any = true;
+            if (flights > 0) std::cout << " (" << values[i] / flights << "/flight)";
+        }
+        if (!any) {
+            std::cout << " unavailable (" << std::strerror(openError) << ")" << std::endl;
+            return;
+        }
+        if (values[0] > 0 && values[1] >= 0) std::cout << ", IPC " << static_cast<double>(values[1]) / values[0];
+        std::cout << std::endl;
+    }
+
+private:
+    struct Event {
+        const char* name;
+        uint64_t config;
+    };
+#ifdef __linux__
+    static constexpr Event EVENTS[NUM_COUNTERS] = {
+        {"cycles", PERF_COUNT_HW_CPU_CYCLES},
+        {"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+        {"cache-misses", PERF_COUNT_HW_CACHE_MISSES},
+        {"branch-misses", PERF_COUNT_HW_BRANCH_MISSES},
+    };
+#else
+    static constexpr Event EVENTS[NUM_COUNTERS] = {
+        {"cycles", 0}, {"instructions", 0}, {"cache-misses", 0}, {"branch-misses", 0}};
+#endif
+
+    int fds[NUM_COUNTERS];
+    long long values[NUM_COUNTERS] = {-1, -1, -1, -1}; // -1 when the counter was unavailable
+    int openError = 0;
+
+    void closeAll() {
+        for (int& fd : fds) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+    }
+};
+
+struct SlotAssignment {
+    int flightId;
+    int runwayId; // 0 if no slot could be found
+    int minute;   // start of the slot, minutes after midnight
+};
+
+// Offline allocation of a full day of flights to runway slots of `slotMinutes`, with at
+// most `hourlyCap` movements per clock hour across the airport. The day is split into
+// windows of whole hours that are filled greedily in parallel (windows touch disjoint
+// slots and hours, so they share nothing). A sequential repair pass then moves flights
+// that overflowed their window into the earliest later slot with room.
+class SlotAllocator {
+public:
+    SlotAllocator(std::vector<int> runwayIds, int slotMinutes, int hourlyCap)
+        : runwayIds(std::move(runwayIds)), slotMinutes(slotMinutes), hourlyCap(hourlyCap),
+          slotsPerDay(24 * 60 / slotMinutes),
+          bookings(this->runwayIds.size() * slotsPerDay, EMPTY), movementsInHour(24, 0) {}
+
+    std::vector<SlotAssignment> allocate(const std::vector<Flight>& flights, int windowHours) {
+        order.clear();
+        for (const auto& flight : flights) order.push_back(&flight);
+        // Earliest requested time first, then the most urgent
+        std::sort(order.begin(), order.end(), [](const Flight* a, const Flight* b) {
+            int ma = std::max(minuteOfDay(a->time), 0), mb = std::max(minuteOfDay(b->time), 0);
+            return ma != mb ? ma < mb : a->priority < b->priority;
+        });
+
+        std::vector<SlotAssignment> assignments(order.size());
+        int windows = (24 + windowHours - 1) / windowHours;
+        std::vector<std::vector<size_t>> overflow(windows);
+        std::vector<std::thread> workers;
+        for (int w = 0; w < windows; ++w) {
+            workers.emplace_back([&, w] {
+                int firstSlot = windowStart(w, windowHours);
+                int endSlot = windowStart(w + 1, windowHours);
+                for (size_t i = 0; i < order.size(); ++i) {
+                    int requested = slotFor(*order[i]);
+                    if (requested < firstSlot || requested >= endSlot) continue;
+                    assignments[i] = place(i, requested, endSlot);
+                    if (assignments[i].runwayId == 0) overflow[w].push_back(i);
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        // Repair: overflowed flights, in window order, take the first later slot with room
+        for (int w = 0; w < windows; ++w) {
+            int nextWindowSlot = windowStart(w + 1, windowHours);
+            for (size_t i : overflow[w]) assignments[i] = place(i, nextWindowSlot, slotsPerDay);
+        }
+        return assignments;
+    }
+
+    // Applies a weather event to an existing allocation. A factor f keeps only every
+    // ceil(f)-th slot of each affected runway open during the event; only the bookings
+    // on slots it closes are displaced and re-placed from their original slot onwards,
+    // so the cost is proportional to the event, not the day. Returns the number moved.
+    int applyWeather(const WeatherEvent& event, std::vector<SlotAssignment>& assignments) {
+        int stride = static_cast<int>(std::ceil(event.factor));
+        int firstSlot = event.startMinute / slotMinutes;
+        int endSlot = std::min(slotsPerDay, (event.endMinute + slotMinutes - 1) / slotMinutes);
+        std::vector<std::pair<int, int32_t>> displaced; // (slot, booking)
+        for (size_t r = 0; r < runwayIds.size(); ++r) {
+            if (event.runwayId != 0 && event.runwayId != runwayIds[r]) continue;
+            for (int slot = firstSlot; slot < endSlot; ++slot) {
+                if ((slot - firstSlot) % stride == 0) continue;
+                int32_t& booking = bookings[r * slotsPerDay + slot];
+                if (booking >= 0) {
+                    displaced.push_back({slot, booking});
+                    --movementsInHour[slot * slotMinutes / 60];
+                }
+                booking = CLOSED;
+            }
+        }
+        std::sort(displaced.begin(), displaced.end());
+        for (auto [slot, booking] : displaced) assignments[booking] = place(booking, slot, slotsPerDay);
+        return static_cast<int>(displaced.size());
+    }
+
+private:
+    static constexpr int32_t EMPTY = -1;
+    static constexpr int32_t CLOSED = -2;
+
+    std::vector<int> runwayIds;
+    int slotMinutes;
+    int hourlyCap;
+    int slotsPerDay;
+    std::vector<const Flight*> order;  // flights in allocation order; bookings index into it
+    std::vector<int32_t> bookings;     // runway-major grid: flight index, EMPTY or CLOSED
+    std::vector<int> movementsInHour;
+
+    // First slot starting in window `w`, rounded up so that a slot belongs to the window
+    // its start falls in and every hour it counts against is that window's
+    int windowStart(int w, int windowHours) const {
+        return std::min(slotsPerDay, (w * windowHours * 60 + slotMinutes - 1) / slotMinutes);
+    }
+
+    int slotFor(const Flight& flight) const {
+        return std::max(minuteOfDay(flight.time), 0) / slotMinutes;
+    }
+
+    // First slot in [fromSlot, endSlot) whose hour has room, on the first free runway
+    SlotAssignment place(size_t index, int fromSlot, int endSlot) {
+        const Flight& flight = *order[index];
+        for (int slot = fromSlot; slot < endSlot;) {
+            int hour = slot * slotMinutes / 60;
+            if (movementsInHour[hour] >= hourlyCap) {
+                // Skip to the first slot starting in the next hour (rounded up, as slot
+                // lengths need not divide 60)
+                slot = (60 * (hour + 1) + slotMinutes - 1) / slotMinutes;
+                continue;
+            }
+            for (size_t r = 0; r < runwayIds.size(); ++r) {
+                int32_t& booking = bookings[r * slotsPerDay + slot];
+                if (booking != EMPTY) continue;
+                booking = static_cast<int32_t>(index);
+                ++movementsInHour[hour];
+                return {flight.id, runwayIds[r], slot * slotMinutes};
+            }
+            ++slot;
+        }
+        return {flight.id, 0, -1};
+    }
+};
+
+// Writes "<flight id> <runway id> <HH:MM>" per allocated flight
+bool writeSlotPlan(const std::string& path, const std::vector<SlotAssignment>& assignments) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+    for (const auto& assignment : assignments) {
+        if (assignment.runwayId == 0) continue;
+        char time[16];
+        std::snprintf(time, sizeof(time), "%02d:%02d", assignment.minute / 60, assignment.minute % 60);
+        file << assignment.flightId << " " << assignment.runwayId << " " << time << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+// Reads a slot plan back as flight id -> planned runway id
+bool loadSlotPlan(const std::string& path, std::map<int, int>& plannedRunways) {
+    std::ifstream file(path);
+    if (!file) return false;
+    int flightId, runwayId;
+    std::string time;
+    while (file >> flightId >> runwayId >> time) plannedRunways[flightId] = runwayId;
+    return true;
+}
+
+// Runway slots preallocated when running from a configuration image, so a reload can
+// open runways without reallocating the runway table under the dispatcher
+constexpr size_t MAX_RUNWAY_SLOTS = 64;
+
+// Builds and publishes a new configuration from the image; runs off the dispatch path
+void reloadConfiguration(const std::string& path) {
+    AirportConfig config;
+    LiveConfig* live = nullptr;
+    if (!loadAirportImage(path, config) || !(live = buildLiveConfig(config, runways.size()))) {
+        std::cout << "Configuration reload from " << path << " failed; keeping current configuration." << std::endl;
+        return;
+    }
+    publishLiveConfig(live);
+    // Pass through the lock so a dispatcher between its predicate check and its wait
+    // cannot miss the newly opened runways
+    { std::lock_guard<std::mutex> lock(runwayMutex); }
+    runwayAvailableCV.notify_one();
+    affineDispatcher.configChanged();
+    std::cout << "Configuration reloaded: " << config.runways.size() << " runways open." << std::endl;
+}
+
+// Reloads the configuration image on SIGHUP or when the file is rewritten, until
+// `stopFd` becomes readable. SIGHUP must already be blocked in every thread.
+void watchConfiguration(std::string path, int stopFd) {
+    setThreadRole(ThreadRole::Watcher);
+    sigset_t hangup;
+    sigemptyset(&hangup);
+    sigaddset(&hangup, SIGHUP);
+    int signalFd = signalfd(-1, &hangup, SFD_CLOEXEC);
+
+    // Watch the directory so that editors replacing the file by rename are noticed too
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : path.substr(0, slash);
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    int inotifyFd = inotify_init1(IN_CLOEXEC);
+    if (inotifyFd >= 0) inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+    pollfd fds[3] = {{stopFd, POLLIN, 0}, {signalFd, POLLIN, 0}, {inotifyFd, POLLIN, 0}};
+    while (true) {
+        // The profiler's SIGPROF interrupts poll() even with SA_RESTART
+        if (::poll(fds, 3, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents) break;
+        bool reload = false;
+        if (fds[1].revents & POLLIN) {
+            signalfd_siginfo info;
+            if (::read(signalFd, &info, sizeof(info)) == sizeof(info)) reload = true;
+        }
+        if (fds[2].revents & POLLIN) {
+            alignas(inotify_event) char buffer[4096];
+            ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+            for (ssize_t offset = 0; offset < length;) {
+                auto* event = reinterpret_cast<inotify_event*>(buffer + offset);
+                if (event->len > 0 && name == event->name) reload = true;
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+        if (reload) reloadConfiguration(path);
+        configEpochs.tryReclaim();
+    }
+
+    if (signalFd >= 0) ::close(signalFd);
+    if (inotifyFd >= 0) ::close(inotifyFd);
+}
+
+// Self-check for epoch reclamation (--stress-epochs ROUNDS). Writer threads publish and
+// retire through a private domain, the flight store and the live runway configuration
+// while reader threads pin and dereference what is published. It fails if a reader
+// finds anything reclaimed while it is pinned, or if a domain's backlog passes
+// MAX_PENDING by more than the writers that can be mid-retire. Retired test objects are
+// only marked and are deleted at the end, so a violation is detected, not undefined;
+// torn runway configurations are caught by their stamp, freed ones by a sanitizer build.
+bool stressEpochs(int rounds) {
+    constexpr int WRITERS = 2;
+    constexpr int READERS = 4;
+    constexpr size_t RUNWAY_SLOTS = 8;
+    constexpr size_t BOARD_SIZE = 64;
+    constexpr size_t BACKLOG_BOUND = EpochDomain::MAX_PENDING + WRITERS;
+
+    struct StressObject {
+        std::atomic<bool> reclaimed{false};
+    };
+    std::mutex graveyardMutex;
+    std::vector<std::unique_ptr<StressObject>> graveyard;
+    std::unique_ptr<StressObject> last;
+    EpochDomain domain; // after the graveyard: its destructor runs the leftover deleters
+    std::atomic<StressObject*> published{new StressObject};
+
+    // Flight handles in use; a writer takes a handle off the board before releasing it
+    std::atomic<int> board[BOARD_SIZE];
+    for (auto& entry : board) entry.store(-1);
+
+    // The runway table the configurations describe; every open runway in a snapshot
+    // carries that snapshot's stamp as its occupancy
+    for (size_t i = runways.size(); i < RUNWAY_SLOTS; ++i) runways.emplace_back(static_cast<int>(i) + 1);
+    auto runwayConfig = [](int stamp) {
+        AirportConfig config;
+        for (size_t i = 0; i < RUNWAY_SLOTS; ++i) {
+            if ((stamp >> i & 1) == 0) config.runways.push_back({static_cast<int32_t>(i) + 1, stamp});
+        }
+        return buildLiveConfig(config, RUNWAY_SLOTS);
+    };
+    publishLiveConfig(runwayConfig(1));
+
+    std::atomic<bool> done{false};
+    std::atomic<long long> reads{0};
+    std::atomic<long long> violations{0};
+    std::atomic<size_t> peakBacklog[3] = {};
+    auto notePeak = [&peakBacklog](int domainIndex, size_t backlog) {
+        size_t peak = peakBacklog[domainIndex].load(std::memory_order_relaxed);
+        while (backlog > peak && !peakBacklog[domainIndex].compare_exchange_weak(peak, backlog)) {}
+    };
+
+    auto writer = [&](int index) {
+        Xoshiro256 rng(index + 1);
+        for (int round = 0; round < rounds; ++round) {
+            StressObject* old = published.exchange(new StressObject, std::memory_order_acq_rel);
+            domain.retire([old, &graveyardMutex, &graveyard] {
+                old->reclaimed.store(true, std::memory_order_release);
+                std::lock_guard<std::mutex> lock(graveyardMutex);
+                graveyard.emplace_back(old);
+            });
+            notePeak(0, domain.pendingCount());
+
+            int handle = flightStore.append(Flight(index * rounds + round + 1, "arrival", 1, "00:00"));
+            if (handle >= 0) {
+                int dropped = board[rng.next() % BOARD_SIZE].exchange(handle, std::memory_order_acq_rel);
+                flightStore.release(dropped);
+            }
+            notePeak(1, flightStore.pendingReleases());
+
+            publishLiveConfig(runwayConfig(static_cast<int>(rng.next() % 1000) + 1));
+            notePeak(2, configEpochs.pendingCount());
+        }
+    };
+
+    auto reader = [&] {
+        while (!done.load(std::memory_order_acquire)) {
+            {
+                auto guard = domain.pin();
+                StressObject* object = published.load(std::memory_order_acquire);
+                for (int spin = 0; spin < 64; ++spin) {
+                    if (object->reclaimed.load(std::memory_order_acquire)) {
+                        violations.fetch_add(1);
+                        break;
+                    }
+                }
+            }
+            {
+                auto guard = flightStore.pin();
+                for (const auto& entry : board) {
+                    int handle = entry.load(std::memory_order_acquire);
+                    if (handle < 0) continue;
+                    if (!flightStore.current(handle) || flightStore.record(handle).flight.handle != handle) {
+                        violations.fetch_add(1);
+                    }
+                }
+            }
+            {
+                auto guard = configEpochs.pin();
+                const LiveConfig* config = liveConfig.load(std::memory_order_acquire);
+                int32_t stamp = 0;
+                for (int32_t occupancy : config->occupancyMs) {
+                    if (occupancy == 0) continue;
+                    if (stamp != 0 && occupancy != stamp) violations.fetch_add(1);
+                    stamp = occupancy;
+                }
+                if (config->occupancyMs.size() != RUNWAY_SLOTS) violations.fetch_add(1);
+            }
+            reads.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> readers, writers;
+    for (int i = 0; i < READERS; ++i) readers.emplace_back(reader);
+    for (int i = 0; i < WRITERS; ++i) writers.emplace_back(writer, i);
+    for (auto& th : writers) th.join();
+    done.store(true, std::memory_order_release);
+    for (auto& th : readers) th.join();
+
+    for (auto& entry : board) flightStore.release(entry.exchange(-1));
+    last.reset(published.exchange(nullptr));
+    bool bounded = true;
+    for (auto& peak : peakBacklog) bounded = bounded && peak.load() <= BACKLOG_BOUND;
+    bool passed = violations.load() == 0 && bounded;
+    std::cout << "Epoch stress: " << rounds << " rounds x " << WRITERS << " writers, " << READERS << " readers, "
+              << reads.load() << " reads; peak backlog " << peakBacklog[0].load() << " objects, "
+              << peakBacklog[1].load() << " flight slots, " << peakBacklog[2].load() << " configurations (bound "
+              << BACKLOG_BOUND << "); " << violations.load() << " reclaimed while pinned: "
+              << (passed ? "passed" : "FAILED") << std::endl;
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    // Optional settings:
+    //   --preempted-capacity N --regular-capacity N --admission reject|block|shed
+    //   --numa-node N --journal PATH --results PATH --event-ring PATH
+    //   --config IMAGE (skips the runway prompt) --drain-timeout-ms N
+    //   --airline-weight CODE=WEIGHT (repeatable) --slot-plan FILE
+    //   --allocate-slots FILE (plan the day's flights offline instead of dispatching them)
+    //   --slot-minutes N --hourly-cap N (slot allocation parameters)
+    //   --seed N (occupancy sampling) --weather FILE
+    //   --optimizer on (follow the rolling horizon optimizer instead of fair-share order)
+    //   --dispatch affine (per-runway queues and workers instead of the central queues)
+    //   --profile PATH (sample scheduler phases; folded stacks written to PATH)
+    //   --perf-counters on (hardware counters around slot allocation or the dispatch run)
+    // or, to follow another scheduler's event ring: --tail PATH
+    // or, to compile a text configuration into an image: --compile-config TEXT IMAGE
+    // or, to self-check epoch reclamation under concurrent readers: --stress-epochs ROUNDS
+    int preemptedCapacity = 256, regularCapacity = 256;
+    int numaNode = -1;
+    std::string journalPath, resultsPath, eventRingPath, configPath;
+    std::optional<std::chrono::milliseconds> drainTimeout;
+    std::string slotPlanPath, allocateSlotsPath, profilePath;
+    int slotMinutes = 2, hourlyCap = INT32_MAX;
+    AdmissionPolicy policy = AdmissionPolicy::BlockProducer;
+    bool affineDispatch = false;
+    bool perfCounters = false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i], value = argv[i + 1];
+        if (option == "--preempted-capacity") {
+            preemptedCapacity = std::stoi(value);
+        } else if (option == "--regular-capacity") {
+            regularCapacity = std::stoi(value);
+        } else if (option == "--admission") {
+            if (value == "reject") policy = AdmissionPolicy::Reject;
+            else if (value == "shed") policy = AdmissionPolicy::ShedLowest;
+            else policy = AdmissionPolicy::BlockProducer;
+        } else if (option == "--numa-node") {
+            numaNode = std::stoi(value);
+        } else if (option == "--journal") {
+            journalPath = value;
+        } else if (option == "--results") {
+            resultsPath = value;
+        } else if (option == "--event-ring") {
+            eventRingPath = value;
+        } else if (option == "--weather") {
+            if (!weather.load(value)) {
+                std::cout << "Could not load weather scenario " << value << "." << std::endl;
+                return 1;
+            }
+        } else if (option == "--seed") {
+            occupancyRng.reseed(std::stoull(value));
+        } else if (option == "--optimizer") {
+            optimizerEnabled = value == "on";
+        } else if (option == "--dispatch") {
+            affineDispatch = value == "affine";
+        } else if (option == "--profile") {
+            profilePath = value;
+        } else if (option == "--perf-counters") {
+            perfCounters = value == "on";
+        } else if (option == "--slot-plan") {
+            slotPlanPath = value;
+        } else if (option == "--allocate-slots") {
+            allocateSlotsPath = value;
+        } else if (option == "--slot-minutes") {
+            slotMinutes = std::max(1, std::min(60, std::stoi(value)));
+        } else if (option == "--hourly-cap") {
+            hourlyCap = std::stoi(value);
+        } else if (option == "--airline-weight") {
+            size_t equals = value.find('=');
+            if (equals != std::string::npos) {
+                airlineWeights[value.substr(0, equals)] = std::stod(value.substr(equals + 1));
+            }
+        } else if (option == "--drain-timeout-ms") {
+            drainTimeout = std::chrono::milliseconds(std::stoi(value));
+        } else if (option == "--config") {
+            configPath = value;
+        } else if (option == "--tail") {
+            return tailEventRing(value);
+        } else if (option == "--stress-epochs") {
+            return stressEpochs(std::stoi(value)) ? 0 : 1;
+        } else if (option == "--compile-config" && i + 2 < argc) {
+            AirportConfig config;
+            if (!loadAirportConfigText(value, config) || !writeAirportImage(argv[i + 2], config)) {
+                std::cout << "Could not compile configuration " << value << "." << std::endl;
+                return 1;
+            }
+            std::cout << "Wrote " << config.runways.size() << " runways to " << argv[i + 2] << "." << std::endl;
+            return 0;
+        }
+    }
+    admission.configure(preemptedCapacity, regularCapacity, policy);
+
+    // Bind before any scheduler state is allocated so it lands on the chosen node
+    if (numaNode >= 0) {
+        if (bindToNumaNode(numaNode)) {
+            std::cout << "Scheduler bound to NUMA node " << numaNode << "." << std::endl;
+        } else {
+            std::cout << "NUMA node " << numaNode << " unavailable; using default placement." << std::endl;
+        }
+    }
+
+    if (!journalPath.empty() && !journal.open(journalPath)) {
+        std::cout << "Could not open journal " << journalPath << "." << std::endl;
+    }
+    if (!resultsPath.empty() && !results.open(resultsPath)) {
+        std::cout << "Could not open results file " << resultsPath << "." << std::endl;
+    }
+    if (!eventRingPath.empty() && !eventRing.create(eventRingPath, 4096)) {
+        std::cout << "Could not create event ring " << eventRingPath << "." << std::endl;
+    }
+
+    int numRunways = 0, numFlights = 0;
+    AirportConfig config;
+    if (!configPath.empty()) {
+        auto loadStart = std::chrono::steady_clock::now();
+        if (!loadAirportImage(configPath, config)) {
+            std::cout << "Could not load configuration image " << configPath << "." << std::endl;
+            return 1;
+        }
+        // Preallocate every slot a reload could open; closed slots are never dispatched to
+        size_t slotCount = MAX_RUNWAY_SLOTS;
+        for (const auto& runway : config.runways) {
+            slotCount = std::max(slotCount, static_cast<size_t>(std::max(runway.id, 0)));
+        }
+        runways.reserve(slotCount);
+        for (size_t i = 0; i < slotCount; ++i) {
+            runways.emplace_back(static_cast<int>(i) + 1);
+        }
+        const LiveConfig* live = buildLiveConfig(config, slotCount);
+        if (!live) {
+            std::cout << "Invalid runway in configuration image " << configPath << "." << std::endl;
+            return 1;
+        }
+        publishLiveConfig(live);
+        auto loadTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - loadStart);
+        std::cout << "Loaded " << config.runways.size() << " runways from " << configPath
+                  << " in " << loadTime.count() << " us." << std::endl;
+    } else {
+        std::cout << "Enter the number of runways: ";
+        std::cin >> numRunways;
+        numRunways = std::max(numRunways, 0); // a negative count means no runways, as it always did
+
+        // Initialize the runways
+        runways.reserve(numRunways);
+        for (int i = 0; i < numRunways; ++i) {
+            runways.emplace_back(i + 1); // Runway IDs start from 1
+        }
+        AirportConfig defaults;
+        for (int i = 0; i < numRunways; ++i) defaults.runways.push_back({i + 1, LANDING_TIME_SECONDS * 1000});
+        publishLiveConfig(buildLiveConfig(defaults, runways.size()));
+    }
+
+    std::cout << "Enter the number of flights: ";
+    std::cin >> numFlights;
+    numFlights = std::max(numFlights, 0);
+    std::vector<Flight> flights;
+    flights.reserve(numFlights);
+
+    // Input flight details
+    for (int i = 0; i < numFlights; ++i) {
+        int id, priority, gate = 0;
+        std::string type, time, rest, airline, category;
+        std::cout << "Enter flight ID, type (arrival/departure), priority, time and optional gate, airline and category (L/M/H/J): ";
+        std::cin >> id >> type >> priority >> time;
+        std::getline(std::cin, rest);
+        std::istringstream(rest) >> gate >> airline >> category;
+
+        Flight flight(id, type, priority, time, gate, airline,
+                      category.empty() ? AircraftCategory::Medium : categoryFromCode(category[0]));
+        flights.push_back(flight);
+    }
+
+    if (!allocateSlotsPath.empty()) {
+        std::vector<int> openRunways;
+        const LiveConfig* config = liveConfig.load();
+        for (size_t i = 0; i < runways.size(); ++i) {
+            if (config->occupancyMs[i] > 0) openRunways.push_back(runways[i].id);
+        }
+        HardwareCounters counters;
+        if (perfCounters) counters.start();
+        auto start = std::chrono::steady_clock::now();
+        SlotAllocator allocator(openRunways, slotMinutes, hourlyCap);
+        std::vector<SlotAssignment> plan = allocator.allocate(flights, 4);
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        if (perfCounters) {
+            counters.stop();
+            counters.print("slot allocation", static_cast<long long>(flights.size()));
+        }
+
+        if (!weather.events.empty()) {
+            auto weatherStart = std::chrono::steady_clock::now();
+            int displaced = 0;
+            for (const auto& event : weather.events) displaced += allocator.applyWeather(event, plan);
+            auto weatherTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - weatherStart);
+            std::cout << "Weather: " << weather.events.size() << " events displaced " << displaced
+                      << " bookings, re-placed in " << weatherTime.count() << " us." << std::endl;
+        }
+        long long unallocated = std::count_if(plan.begin(), plan.end(),
+                                              [](const SlotAssignment& a) { return a.runwayId == 0; });
+        if (!writeSlotPlan(allocateSlotsPath, plan)) {
+            std::cout << "Could not write slot plan " << allocateSlotsPath << "." << std::endl;
+            return 1;
+        }
+        std::cout << "Allocated " << plan.size() - unallocated << " of " << plan.size() << " flights to slots in "
+                  << elapsed.count() << " us; plan written to " << allocateSlotsPath << "." << std::endl;
+        return 0;
+    }
+
+    if (!slotPlanPath.empty()) {
+        std::map<int, int> plannedRunways;
+        if (!loadSlotPlan(slotPlanPath, plannedRunways)) {
+            std::cout << "Could not load slot plan " << slotPlanPath << "." << std::endl;
+        }
+        for (auto& flight : flights) {
+            auto it = plannedRunways.find(flight.id);
+            if (it != plannedRunways.end()) flight.plannedRunway = it->second;
+        }
+    }
+
+    // With a configuration image, reload it on SIGHUP or when the file changes. SIGHUP is
+    // blocked here so every thread started below inherits the mask and the watcher's
+    // signalfd is the only place it is delivered.
+    std::thread watcherThread;
+    int stopWatcherFd = -1;
+    if (!configPath.empty()) {
+        sigset_t hangup;
+        sigemptyset(&hangup);
+        sigaddset(&hangup, SIGHUP);
+        pthread_sigmask(SIG_BLOCK, &hangup, nullptr);
+        stopWatcherFd = eventfd(0, EFD_CLOEXEC);
+        watcherThread = std::thread(watchConfiguration, configPath, stopWatcherFd);
+    }
+
+    HardwareCounters dispatchCounters;
+    if (perfCounters) dispatchCounters.start();
+    setThreadRole(ThreadRole::Main);
+    PhaseProfiler profiler;
+    if (!profilePath.empty() && !profiler.start()) {
+        std::cout << "Profiling unavailable; continuing without it." << std::endl;
+        profilePath.clear();
+    }
+
+    // Launch a thread to monitor and handle waiting flights. Under affine dispatch the
+    // runway workers do the dispatching and the monitor only sees the drain through.
+    std::thread monitorThread(checkWaitingFlights);
+    if (affineDispatch) affineDispatcher.start();
+
+    std::optional<RollingHorizonOptimizer> optimizer;
+    std::thread optimizerThread;
+    if (optimizerEnabled) {
+        optimizer.emplace();
+        optimizerThread = std::thread([&optimizer] { optimizer->run(std::chrono::milliseconds(100)); });
+    }
+
+    // Arrivals and departures both go through admission control into the runway queues
+    for (auto& flight : flights) {
+        if (flight.type == "arrival" || flight.type == "departure") {
+            flight.handle = flightStore.append(flight);
+            if (flight.handle < 0) {
+                std::cout << "Flight ID: " << flight.id << " rejected: flight store is full." << std::endl;
+                continue;
+            }
+            flightStatus.track(flight.handle);
+            submitFlight(flight);
+        }
+    }
+
+    // No more flights will arrive; let the monitor finish once the queues drain
+    beginDrain(drainTimeout);
+
+    // Block until every accepted flight has landed or been cancelled, then let the
+    // monitor finish joining its landing threads
+    completion.waitAllDone();
+    monitorThread.join();
+    if (affineDispatcher.enabled()) affineDispatcher.stop();
+
+    if (optimizerThread.joinable()) {
+        optimizer->stop();
+        optimizerThread.join();
+        sequenceEpochs.tryReclaim();
+    }
+
+    if (watcherThread.joinable()) {
+        uint64_t stop = 1;
+        if (::write(stopWatcherFd, &stop, sizeof(stop)) == sizeof(stop)) watcherThread.join();
+        ::close(stopWatcherFd);
+    }
+    profiler.stop();
+    if (perfCounters) dispatchCounters.stop();
+
+    if (completion.allDone() && schedulerState == SchedulerState::Stopped) {
+        if (flightsCancelled > 0) {
+            std::cout << flightsCancelled << " queued flights were cancelled at the drain deadline. Exiting system." << std::endl;
+        } else {
+            std::cout << "All flights have landed or taken off. Exiting system." << std::endl;
+        }
+    }
+
+    admission.printMetrics();
+    flightStatus.printCounts();
+    if (optimizer) optimizer->printReport();
+    runwayMatcher.printReport();
+    affineDispatcher.printReport();
+    if (perfCounters) {
+        dispatchCounters.print("dispatch", flightStatus.count(FlightState::Completed));
+    }
+    if (!profilePath.empty()) {
+        profiler.printBreakdown();
+        if (!profiler.writeFolded(profilePath)) std::cout << "Could not write profile " << profilePath << "." << std::endl;
+    }
+
+    // Per-airline share of dispatched flights and mean queueing delay
+    long long totalDispatched = 0;
+    for (const auto& [airline, stats] : airlineStats) totalDispatched += stats.dispatched;
+    for (const auto& [airline, stats] : airlineStats) {
+        if (stats.dispatched == 0) continue;
+        std::cout << "Airline " << (airline.empty() ? "(none)" : airline) << " (weight " << airlineWeight(airline)
+                  << "): " << stats.dispatched << " flights, " << 100.0 * stats.dispatched / totalDispatched
+                  << "% share, mean delay " << stats.totalDelayMs / stats.dispatched << " ms" << std::endl;
+    }
+    if (totalDispatched > 0) {
+        long long totalDelayMs = 0;
+        double weightedDelayMs = 0, totalWeight = 0;
+        for (const auto& [airline, stats] : airlineStats) {
+            totalDelayMs += stats.totalDelayMs;
+            weightedDelayMs += stats.weightedDelayMs;
+            totalWeight += stats.totalWeight;
+        }
+        std::cout << "Queueing delay: mean " << static_cast<double>(totalDelayMs) / totalDispatched
+                  << " ms, priority-weighted mean " << weightedDelayMs / totalWeight << " ms over " << totalDispatched
+                  << " flights" << std::endl;
+    }
+
+    // Report how many write syscalls each sink needed per record
+    for (EventSink* sink : {&journal, &results}) {
+        if (!sink->isOpen()) continue;
+        const char* name = sink == &journal ? "Journal" : "Results";
+        const char* backend = sink->backendName();
+        sink->close();
+        std::cout << name << " (" << backend << "): " << sink->records << " records, "
+                  << sink->syscalls << " syscalls";
+        if (sink->records > 0) {
+            std::cout << " (" << static_cast<double>(sink->syscalls) / sink->records << " per record)";
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}